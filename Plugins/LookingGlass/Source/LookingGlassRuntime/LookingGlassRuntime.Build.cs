@@ -73,14 +73,27 @@ namespace UnrealBuildTool.Rules
                 }
                 );
 
+            // Parallel PNG encoder of quilt screenshots
+            AddEngineThirdPartyPrivateStaticDependencies(Target, "zlib");
+
             if (Target.bBuildEditor == true)
             {
                 PrivateDependencyModuleNames.Add("UnrealEd");
 				PrivateDependencyModuleNames.Add("Sequencer");
 			}
 
-			string BridgeDirectoryName = "LookingGlassBridge";
-            PublicIncludePaths.Add(Path.Combine(GetThirdPartyPath(), BridgeDirectoryName, "Include"));
+			// Bridge presents on the device through D3D interop, so it's used on Windows only. Other platforms build
+			// without it, e.g. to run the image encoder benchmark headless on Linux.
+			if (Target.Platform == UnrealTargetPlatform.Win64)
+			{
+				string BridgeDirectoryName = "LookingGlassBridge";
+				PublicIncludePaths.Add(Path.Combine(GetThirdPartyPath(), BridgeDirectoryName, "Include"));
+				PrivateDefinitions.Add("WITH_LOOKINGGLASS_BRIDGE=1");
+			}
+			else
+			{
+				PrivateDefinitions.Add("WITH_LOOKINGGLASS_BRIDGE=0");
+			}
         }
     }
 }
@@ -6,11 +6,16 @@
 #include "Misc/LookingGlassLog.h"
 #include "Misc/LookingGlassStats.h"
 #include "ILookingGlassRuntime.h" // for Editor/GameLookingGlassCaptureComponents
+#include "Render/LookingGlassViewSynthesis.h"
+#include "Render/LookingGlassRenderTargetPool.h"
+#include "Render/LookingGlassInterleaver.h"
 
 #include "SceneInterface.h"
 #include "Engine/World.h"
 #include "Math/UnrealMathUtility.h"
 #include "Engine/TextureRenderTarget2D.h"
+#include "RHI.h"
+#include "RenderCore.h" // for GGameThreadTime, GRenderThreadTime
 
 // For focus plane mesh and component
 #include "UObject/ConstructorHelpers.h"
@@ -24,7 +29,6 @@ static ELookingGlassQualitySettings GlobalTilingQuailty = ELookingGlassQualitySe
 static bool IsGlobalTilingQualitySet = false;
 
 ULookingGlassSceneCaptureComponent2D::ULookingGlassSceneCaptureComponent2D()
-	: RenderingConfigs(this)
 {
 	TextureTarget = nullptr;
 	SetHiddenInGame(false);
@@ -48,6 +52,12 @@ ULookingGlassSceneCaptureComponent2D::ULookingGlassSceneCaptureComponent2D()
 	const ULookingGlassSettings* LookingGlassSettings = GetDefault<ULookingGlassSettings>();
 	TilingValues = LookingGlassSettings->_GoPortrait_Settings;
 	CustomTilingValues = LookingGlassSettings->CustomSettings;
+
+	// Full resolution at the centre, half at the outermost views
+	FRichCurve* ResolutionCurve = ViewResolutionCurve.GetRichCurve();
+	ResolutionCurve->AddKey(0.0f, 1.0f);
+	ResolutionCurve->AddKey(0.3f, 1.0f);
+	ResolutionCurve->AddKey(1.0f, 0.5f);
 }
 
 void ULookingGlassSceneCaptureComponent2D::AddReferencedObjects(UObject* InThis, FReferenceCollector& Collector)
@@ -125,6 +135,7 @@ void ULookingGlassSceneCaptureComponent2D::OnComponentDestroyed(bool bDestroying
 	Super::OnComponentDestroyed(bDestroyingHierarchy);
 
 	RenderingConfigs.Release();
+	Release2DRenderTarget();
 
 #if WITH_EDITOR
 	if (DrawFrustum)
@@ -230,6 +241,7 @@ void ULookingGlassSceneCaptureComponent2D::EndPlay(const EEndPlayReason::Type En
 
 	// It should automatically clean all render texture targets
 	RenderingConfigs.Release();
+	Release2DRenderTarget();
 
 	ILookingGlassRuntime::Get().GameLookingGlassCaptureComponents.Remove(this);
 }
@@ -303,7 +315,9 @@ void ULookingGlassSceneCaptureComponent2D::PostEditChangeProperty(struct FProper
 	{
 		FName PropertyName = PropertyChangedEvent.Property->GetFName();
 
-		if (PropertyName == GET_MEMBER_NAME_CHECKED(ULookingGlassSceneCaptureComponent2D, TilingQuality))
+		if (PropertyName == GET_MEMBER_NAME_CHECKED(ULookingGlassSceneCaptureComponent2D, TilingQuality) ||
+			PropertyName == GET_MEMBER_NAME_CHECKED(ULookingGlassSceneCaptureComponent2D, bLenticularTiling) ||
+			PropertyName == GET_MEMBER_NAME_CHECKED(ULookingGlassSceneCaptureComponent2D, MaxViewAngleStep))
 		{
 			UpdateTilingProperties();
 		}
@@ -311,7 +325,16 @@ void ULookingGlassSceneCaptureComponent2D::PostEditChangeProperty(struct FProper
 			PropertyName == GET_MEMBER_NAME_CHECKED(FLookingGlassTilingQuality, TilesY) ||
 			PropertyName == GET_MEMBER_NAME_CHECKED(FLookingGlassTilingQuality, QuiltW) ||
 			PropertyName == GET_MEMBER_NAME_CHECKED(FLookingGlassTilingQuality, QuiltH) ||
-			PropertyName == GET_MEMBER_NAME_CHECKED(ULookingGlassSceneCaptureComponent2D, bSingleViewMode)
+			PropertyName == GET_MEMBER_NAME_CHECKED(ULookingGlassSceneCaptureComponent2D, bSingleViewMode) ||
+			PropertyName == GET_MEMBER_NAME_CHECKED(ULookingGlassSceneCaptureComponent2D, bRenderDirectToQuilt) ||
+			PropertyName == GET_MEMBER_NAME_CHECKED(ULookingGlassSceneCaptureComponent2D, bMultiViewRendering) ||
+			PropertyName == GET_MEMBER_NAME_CHECKED(ULookingGlassSceneCaptureComponent2D, bAutoViewBatching) ||
+			PropertyName == GET_MEMBER_NAME_CHECKED(ULookingGlassSceneCaptureComponent2D, VRAMBudgetMB) ||
+			PropertyName == GET_MEMBER_NAME_CHECKED(ULookingGlassSceneCaptureComponent2D, PixelFormat) ||
+			PropertyName == GET_MEMBER_NAME_CHECKED(ULookingGlassSceneCaptureComponent2D, bViewSynthesis) ||
+			PropertyName == GET_MEMBER_NAME_CHECKED(ULookingGlassSceneCaptureComponent2D, ViewSynthesisStep) ||
+			PropertyName == GET_MEMBER_NAME_CHECKED(ULookingGlassSceneCaptureComponent2D, bAmortizedRendering) ||
+			PropertyName == GET_MEMBER_NAME_CHECKED(ULookingGlassSceneCaptureComponent2D, AmortizedRenderingSteps)
 			)
 		{
 			// Reset our render textures and configuration after it
@@ -428,6 +451,28 @@ FMatrix ULookingGlassSceneCaptureComponent2D::GenerateProjectionMatrix(float Off
 	return PerspectiveMatrix;
 }
 
+bool ULookingGlassSceneCaptureComponent2D::IsViewSynthesisEnabled() const
+{
+#if WITH_LOOKINGGLASS_VIEW_SYNTHESIS
+	return bViewSynthesis && !bRenderDirectToQuilt && GetDefault<ULookingGlassSettings>()->LookingGlassRenderingSettings.bBatchedQuiltCopy;
+#else
+	return false;
+#endif
+}
+
+float ULookingGlassSceneCaptureComponent2D::GetViewProjectionOffset(int32 QuiltViewIndex) const
+{
+	const int32 NumTiles = TilingValues.GetNumTiles();
+	if (NumTiles <= 1)
+	{
+		return 0.0f;
+	}
+	// Same as in RenderViews()
+	const float ViewConeSweep = GetCameraDistance() * FMath::Tan(FMath::DegreesToRadians(GetViewCone()));
+	const float CurrentViewLerp = (float)QuiltViewIndex / (NumTiles - 1.f) - .5f;
+	return CurrentViewLerp * ViewConeSweep / Size;
+}
+
 float ULookingGlassSceneCaptureComponent2D::GetAspectRatio() const
 {
 	const ULookingGlassSettings* LookingGlassSettings = GetDefault<ULookingGlassSettings>();
@@ -479,42 +524,164 @@ float ULookingGlassSceneCaptureComponent2D::GetCameraDistance() const
 	return Size / FMath::Tan(FMath::DegreesToRadians(FOV * 0.5f));
 }
 
-void FLookingGlassRenderingConfigs::Build(const FLookingGlassTilingQuality& TilingValues, bool bSingleViewMode)
+// Rough size of scene textures allocated by the deferred renderer for every pixel of the view family: scene color,
+// depth-stencil, GBuffer, velocity and temporal AA history
+static constexpr float SceneTextureBytesPerPixel = 56.0f;
+
+float FLookingGlassRenderingConfigs::EstimateMemoryMB(const FIntPoint& ViewSize, EPixelFormat Format, int32 NumViews)
+{
+	int32 ViewRows, ViewColumns;
+	FLookingGlassRenderingConfig::CalculateTextureLayout(ViewSize, NumViews, ViewRows, ViewColumns);
+	const double NumPixels = double(ViewSize.X * ViewColumns) * double(ViewSize.Y * ViewRows);
+
+	// Scene textures and the intermediate render target which holds the batch
+	const double Bytes = NumPixels * (SceneTextureBytesPerPixel + GPixelFormats[Format].BlockBytes);
+	return float(Bytes / (1024.0 * 1024.0));
+}
+
+int32 FLookingGlassRenderingConfigs::PlanViewBatchSize(const FIntPoint& ViewSize, EPixelFormat Format, int32 MaxViewCount, float BudgetMB)
 {
+	// Memory grows with the number of views, so search for the largest batch which fits
+	int32 Low = 1;
+	int32 High = FMath::Max(MaxViewCount, 1);
+	while (Low < High)
+	{
+		int32 Mid = (Low + High + 1) / 2;
+		if (EstimateMemoryMB(ViewSize, Format, Mid) <= BudgetMB)
+		{
+			Low = Mid;
+		}
+		else
+		{
+			High = Mid - 1;
+		}
+	}
+	return Low;
+}
+
+float FLookingGlassRenderingConfigs::EstimateDirectMemoryMB(const FLookingGlassTilingQuality& TilingValues, ELookingGlassQuiltOrder QuiltOrder, const TArray<int32>& RenderedViews, int32 BatchSize)
+{
+	BatchSize = FMath::Max(BatchSize, 1);
+	double MaxPixels = 0.0;
+	for (int32 FirstView = 0; FirstView < RenderedViews.Num(); FirstView += BatchSize)
+	{
+		// Scene textures are allocated from the origin of the render target to the furthest view rectangle
+		FIntPoint Extent(0, 0);
+		for (int32 Index = FirstView; Index < FMath::Min(FirstView + BatchSize, RenderedViews.Num()); ++Index)
+		{
+			FIntRect TileRect;
+			FLookingGlassRenderingConfig::CalculateQuiltTileRect(TileRect, TilingValues, QuiltOrder, RenderedViews[Index]);
+			Extent = Extent.ComponentMax(TileRect.Max);
+		}
+		MaxPixels = FMath::Max(MaxPixels, double(Extent.X) * double(Extent.Y));
+	}
+	return float(MaxPixels * SceneTextureBytesPerPixel / (1024.0 * 1024.0));
+}
+
+int32 FLookingGlassRenderingConfigs::PlanDirectViewBatchSize(const FLookingGlassTilingQuality& TilingValues, ELookingGlassQuiltOrder QuiltOrder, const TArray<int32>& RenderedViews, int32 MaxViewCount, float BudgetMB)
+{
+	// Memory isn't monotonic in the batch size here, so check every size, from the largest one
+	int32 BestBatchSize = FMath::Max(MaxViewCount, 1);
+	float BestMemoryMB = TNumericLimits<float>::Max();
+	for (int32 BatchSize = FMath::Max(MaxViewCount, 1); BatchSize >= 1; --BatchSize)
+	{
+		const float MemoryMB = EstimateDirectMemoryMB(TilingValues, QuiltOrder, RenderedViews, BatchSize);
+		if (MemoryMB <= BudgetMB)
+		{
+			return BatchSize;
+		}
+		if (MemoryMB < BestMemoryMB)
+		{
+			BestMemoryMB = MemoryMB;
+			BestBatchSize = BatchSize;
+		}
+	}
+
+	UE_LOG(LookingGlassLogGame, Warning, TEXT("Direct-to-quilt rendering needs %.1f MB of scene textures, over the budget of %.1f MB. Disable bRenderDirectToQuilt to render views in quilt independent batches."),
+		BestMemoryMB, BudgetMB);
+	return BestBatchSize;
+}
+
+void FLookingGlassRenderingConfigs::Build(const FLookingGlassTilingQuality& TilingValues, bool bSingleViewMode, bool bDirectToQuilt, bool bMultiView, int32 VRAMBudgetMB,
+	EPixelFormat Format, int32 SynthesisStep, int32 AmortizationSteps, float InRenderScale)
+{
+	// Applied when rendering, so it's never a reason for rebuilding render targets
+	RenderScale = bDirectToQuilt ? 1.0f : FMath::Clamp(InRenderScale, 0.1f, 1.0f);
+
 	int32 NumTiles = TilingValues.GetNumTiles();
+	FIntPoint ViewSize(TilingValues.TileSizeX, TilingValues.TileSizeY);
+
+	// Views which are rendered; the others are synthesized from their neighbours
+	TArray<int32> RenderedViews;
+	const bool bSynthesis = SynthesisStep > 1 && !bDirectToQuilt && NumTiles > 2;
+	GetRenderedViews(NumTiles, bSynthesis ? SynthesisStep : 1, RenderedViews);
+	const int32 NumRenderedViews = RenderedViews.Num();
+
 	int32 MaxViewCount = FLookingGlassRenderingConfig::MaxView;
-	if (bSingleViewMode)
+	if (bDirectToQuilt && bMultiView)
+	{
+		// Views are not limited by the size of intermediate render target or by quilt copy pass, render all of them at once
+		MaxViewCount = FMath::Max(NumTiles, 1);
+	}
+
+	// Views rendered in place make scene textures reach their quilt tiles
+	const ELookingGlassQuiltOrder QuiltOrder = GetDefault<ULookingGlassSettings>()->LookingGlassRenderingSettings.QuiltOrder;
+	if (VRAMBudgetMB > 0 && bDirectToQuilt)
+	{
+		MaxViewCount = PlanDirectViewBatchSize(TilingValues, QuiltOrder, RenderedViews, FMath::Min(MaxViewCount, FMath::Max(NumRenderedViews, 1)), VRAMBudgetMB);
+	}
+	else if (VRAMBudgetMB > 0)
+	{
+		MaxViewCount = PlanViewBatchSize(ViewSize, Format, FMath::Min(MaxViewCount, FMath::Max(NumRenderedViews, 1)), VRAMBudgetMB);
+	}
+	else if (bSingleViewMode && !(bDirectToQuilt && bMultiView))
 	{
 		MaxViewCount = 1;
 	}
-	int32 NumConfiguraions = (NumTiles + MaxViewCount - 1) / MaxViewCount;
+	if (AmortizationSteps > 1)
+	{
+		// Every step refreshes its own configs
+		MaxViewCount = FMath::Min(MaxViewCount, FMath::Max(FMath::DivideAndRoundUp(NumRenderedViews, AmortizationSteps), 1));
+	}
+	int32 NumConfiguraions = (NumRenderedViews + MaxViewCount - 1) / MaxViewCount;
+
+	const int32 NewViewBatchSize = FMath::Min(MaxViewCount, NumRenderedViews);
 
 	// Do not rebuild render targets if nothing has been changed. Compare parameters which are considered
 	// for building a new configuration set.
-	if (CachedTilingValues == TilingValues && Configs.Num() == NumConfiguraions)
+	if (CachedTilingValues == TilingValues && Configs.Num() == NumConfiguraions && bCachedDirectToQuilt == bDirectToQuilt &&
+		ViewBatchSize == NewViewBatchSize && CachedFormat == Format && bCachedSynthesis == bSynthesis && CachedSynthesisStep == SynthesisStep &&
+		CachedAmortizationSteps == AmortizationSteps)
 	{
 		return;
 	}
+	ViewBatchSize = NewViewBatchSize;
+	EstimatedMemoryMB = bDirectToQuilt ? EstimateDirectMemoryMB(TilingValues, QuiltOrder, RenderedViews, ViewBatchSize) : EstimateMemoryMB(ViewSize, Format, ViewBatchSize);
 	CachedTilingValues = TilingValues;
+	bCachedDirectToQuilt = bDirectToQuilt;
+	CachedFormat = Format;
+	bCachedSynthesis = bSynthesis;
+	CachedSynthesisStep = SynthesisStep;
+	CachedAmortizationSteps = AmortizationSteps;
+	bNeedsFullRefresh = true;
 
 	// Release previous setup for building a new one
 	Release();
 
-	FIntPoint ViewSize(TilingValues.TileSizeX, TilingValues.TileSizeY);
+	UE_LOG(LookingGlassLogGame, Log, TEXT("Rendering %d of %d views in %d batches of up to %d views, estimated %.1f MB per batch (budget %d MB)"),
+		NumRenderedViews, NumTiles, NumConfiguraions, ViewBatchSize, EstimatedMemoryMB, VRAMBudgetMB);
 
-	uint32 MinTextureIndex = 0;
-
-	for (int32 CurrentView = 0; CurrentView < NumTiles; CurrentView++)
+	for (int32 FirstView = 0; FirstView < NumRenderedViews; FirstView += MaxViewCount)
 	{
-		// Add new render target
-		if (((CurrentView + 1) % MaxViewCount == 0) ||		// end of row
-			(CurrentView + 1 == NumTiles))					// the last tile
-		{
-			FLookingGlassRenderingConfig& Config = Configs.AddDefaulted_GetRef();
-			Config.Init(Owner, MinTextureIndex, CurrentView, ViewSize);
+		const int32 NumViews = FMath::Min(MaxViewCount, NumRenderedViews - FirstView);
+		TArray<int32> QuiltViewIndices(RenderedViews.GetData() + FirstView, NumViews);
 
-			// Prepare for the next row
-			MinTextureIndex = CurrentView + 1;
+		FLookingGlassRenderingConfig& Config = Configs.AddDefaulted_GetRef();
+		// Views rendered directly into the quilt don't need an intermediate render target
+		Config.Init(MoveTemp(QuiltViewIndices), ViewSize, !bDirectToQuilt, Format);
+		if (bSynthesis)
+		{
+			Config.EnableDepthCapture();
 		}
 	}
 	check(Configs.Num() == NumConfiguraions);
@@ -525,6 +692,20 @@ void FLookingGlassRenderingConfigs::Build(const FLookingGlassTilingQuality& Tili
 	}
 }
 
+void FLookingGlassRenderingConfigs::GetRenderedViews(int32 NumTiles, int32 SynthesisStep, TArray<int32>& OutViews)
+{
+	OutViews.Reset();
+	for (int32 ViewIndex = 0; ViewIndex < NumTiles; ViewIndex += FMath::Max(SynthesisStep, 1))
+	{
+		OutViews.Add(ViewIndex);
+	}
+	// The last view is always rendered, so every synthesized view has rendered neighbours on both sides
+	if (NumTiles > 0 && OutViews.Last() != NumTiles - 1)
+	{
+		OutViews.Add(NumTiles - 1);
+	}
+}
+
 void ULookingGlassSceneCaptureComponent2D::SetTilingProperties(ELookingGlassQualitySettings InTilingQuailty)
 {
 	if (TilingQuality != InTilingQuailty)
@@ -567,7 +748,10 @@ void ULookingGlassSceneCaptureComponent2D::UpdateTilingProperties()
 		TilingValues = LookingGlassSettings->GetTilingQualityFor(TilingSettings);
 	}
 
-
+	if (bLenticularTiling)
+	{
+		ApplyLenticularTiling(TilingValues);
+	}
 
 	// Reset our render textures and configuration after it
 	RebuildRenderConfigs();
@@ -575,6 +759,48 @@ void ULookingGlassSceneCaptureComponent2D::UpdateTilingProperties()
 	UpdateCameraPosition();
 }
 
+bool ULookingGlassSceneCaptureComponent2D::ApplyLenticularTiling(FLookingGlassTilingQuality& InOutTilingValues) const
+{
+	const FLGDeviceCalibration& Calibration = ILookingGlassRuntime::Get().GetCurrentCalibration();
+	LookingGlass::FLenticularParams Params;
+	if (!Params.Init(Calibration))
+	{
+		return false;
+	}
+
+	// The phase makes a full cycle per lens, so it gives the number of lenses across the panel. Every lens shows every
+	// view once per row, and the slant shifts the lenses by 1 / Slope pixel per row, which adds |Slope| distinct
+	// phases per pixel before the pattern repeats.
+	const float LensesAcross = FMath::Abs(Params.PhaseU);
+	const int32 ResolvableViews = FMath::CeilToInt(Calibration.Width / LensesAcross * FMath::Abs(Calibration.Slope));
+
+	const float ViewCone = Calibration.ViewCone > 0.0f ? Calibration.ViewCone : InOutTilingValues.ViewCone;
+	const int32 MaxViews = FMath::Min(ResolvableViews, InOutTilingValues.GetNumTiles());
+	const int32 NumViews = FMath::Clamp(FMath::CeilToInt(ViewCone / FMath::Max(MaxViewAngleStep, 0.1f)), 2, FMath::Max(MaxViews, 2));
+
+	FIntPoint ViewSize(
+		FMath::Min(FMath::CeilToInt(LensesAcross), InOutTilingValues.TileSizeX),
+		FMath::Min(Calibration.Height, InOutTilingValues.TileSizeY));
+
+	// Roughly square quilt, all tiles are used as views
+	const int32 TilesX = FMath::Clamp(FMath::RoundToInt(FMath::Sqrt((float)NumViews * ViewSize.Y / ViewSize.X)), 1, 16);
+	const int32 TilesY = FMath::Clamp(FMath::DivideAndRoundUp(NumViews, TilesX), 1, 160);
+
+	// Largest quilt size allowed by the tiling settings
+	const int32 MaxQuiltSize = 8192;
+	ViewSize.X = FMath::Max(FMath::Min(ViewSize.X, MaxQuiltSize / TilesX), 1);
+	ViewSize.Y = FMath::Max(FMath::Min(ViewSize.Y, MaxQuiltSize / TilesY), 1);
+
+	const int32 PresetPixels = InOutTilingValues.GetNumTiles() * InOutTilingValues.TileSizeX * InOutTilingValues.TileSizeY;
+	InOutTilingValues = FLookingGlassTilingQuality(TEXT("Lenticular"), TilesX, TilesY, TilesX * ViewSize.X, TilesY * ViewSize.Y,
+		InOutTilingValues.Aspect, InOutTilingValues.ViewCone);
+
+	UE_LOG(LookingGlassLogGame, Log, TEXT("Lenticular tiling for %s: %d views of %dx%d (lenses %.1f, resolvable views %d), %.0f%% of preset pixels"),
+		*Calibration.Name, TilesX * TilesY, ViewSize.X, ViewSize.Y, LensesAcross, ResolvableViews,
+		PresetPixels > 0 ? 100.0 * TilesX * TilesY * ViewSize.X * ViewSize.Y / PresetPixels : 100.0);
+	return true;
+}
+
 void ULookingGlassSceneCaptureComponent2D::UpdateTilingPropertiesForAllComponents()
 {
 	auto& LookingGlassRuntime = ILookingGlassRuntime::Get();
@@ -727,12 +953,28 @@ void ULookingGlassSceneCaptureComponent2D::SetupPostprocessing()
 }
 
 // Called by LookingGlassViewportClient used for capturing new snapshot of scene from SceneCapture (RenderCamera)
-void ULookingGlassSceneCaptureComponent2D::RenderViews()
+void ULookingGlassSceneCaptureComponent2D::RenderViews(UTextureRenderTarget2D* QuiltRT)
 {
+	const bool bDirectToQuilt = bRenderDirectToQuilt && QuiltRT != nullptr;
+	if (bRenderDirectToQuilt && QuiltRT == nullptr)
+	{
+		UE_LOG(LookingGlassLogGame, Error, TEXT("Direct-to-quilt rendering requires a quilt render target"));
+		return;
+	}
+	const ELookingGlassQuiltOrder QuiltOrder = GetDefault<ULookingGlassSettings>()->LookingGlassRenderingSettings.QuiltOrder;
+
+	UpdateTilingQualityGovernor();
+
+	// Properties could be changed from blueprints without PostEditChangeProperty, make sure the configs match them.
+	// This is cheap when nothing has been changed.
+	RebuildRenderConfigs();
+
 	SetupPostprocessing();
 
 	// Release RT used for 2D rendering, if any
-	TextureTarget2DRendering = nullptr;
+	Release2DRenderTarget();
+
+	LastRenderTime = FPlatformTime::Seconds();
 
 	// Setup all render targets
 	float CamDistance = GetCameraDistance();
@@ -758,15 +1000,43 @@ void ULookingGlassSceneCaptureComponent2D::RenderViews()
 		FPlane(0, 1, 0, 0),
 		FPlane(0, 0, 0, 1));
 
-	for (FLookingGlassRenderingConfig& RenderingConfig : RenderingConfigs.Configs)
+	// With amortized rendering, configs are split into interleaved groups and a single group is rendered per frame.
+	// Render targets of the other configs still hold views of previous frames, and they are copied to the quilt as well.
+	int32 NumGroups = 1;
+	if (IsAmortizedRenderingEnabled() && !ShouldRefreshAllViews())
+	{
+		NumGroups = FMath::Min(AmortizedRenderingSteps, RenderingConfigs.Configs.Num());
+	}
+	const int32 RenderedGroup = AmortizedFrameIndex++ % NumGroups;
+
+	const bool bScaleViews = bPerViewResolution && !bDirectToQuilt;
+	if (bScaleViews)
+	{
+		UpdateViewResolutionGovernor();
+	}
+
+	for (int32 ConfigIndex = 0; ConfigIndex < RenderingConfigs.Configs.Num(); ++ConfigIndex)
 	{
-		// Rendering target is initialized as 1x1 texture, so it won't take much space until rendering starts.
-		// We should resize the target before rendering.
-		RenderingConfig.PrepareRT();
+		if (ConfigIndex % NumGroups != RenderedGroup)
+		{
+			continue;
+		}
+		FLookingGlassRenderingConfig& RenderingConfig = RenderingConfigs.Configs[ConfigIndex];
+
+		if (bDirectToQuilt)
+		{
+			// Every view writes its own tile of the quilt, so the quilt is the only render target we need
+			TextureTarget = QuiltRT;
+		}
+		else
+		{
+			// Rendering target is leased from the pool only when rendering starts
+			RenderingConfig.PrepareRT();
 
-		// Set render target texture to SceneCaptureComponent. The rendering code which is called from
-		// this function receives RenderingConfig as input, but it relies on TextureTarget to be set
-		TextureTarget = RenderingConfig.GetRenderTarget();
+			// Set render target texture to SceneCaptureComponent. The rendering code which is called from
+			// this function receives RenderingConfig as input, but it relies on TextureTarget to be set
+			TextureTarget = RenderingConfig.GetRenderTarget();
+		}
 
 		int32 NumViews = RenderingConfig.GetNumViews();
 		check(NumViews);
@@ -777,7 +1047,7 @@ void ULookingGlassSceneCaptureComponent2D::RenderViews()
 			float CurrentViewLerp = 0.f;
 			if (NumTiles > 1)
 			{
-				CurrentViewLerp = (float)(RenderingConfig.GetFirstViewIndex() + ViewIndex) / (NumTiles - 1.f) - .5f;
+				CurrentViewLerp = (float)RenderingConfig.GetQuiltViewIndex(ViewIndex) / (NumTiles - 1.f) - .5f;
 			}
 
 			float ViewOffsetX = CurrentViewLerp * ViewConeSweep;
@@ -797,10 +1067,26 @@ void ULookingGlassSceneCaptureComponent2D::RenderViews()
 			ViewInfo.ViewRotationMatrix = ViewRotationMatrix;
 			ViewInfo.ViewLocation = ViewLocation;
 			ViewInfo.ProjectionMatrix = GenerateProjectionMatrix(ProjOffsetX, 0.f);
+
+			if (bDirectToQuilt)
+			{
+				// Place the view at its tile. Done every frame, because QuiltOrder could be changed at any time.
+				CalculateQuiltTileRect(ViewInfo.ViewRect, TilingValues, QuiltOrder, RenderingConfig.GetQuiltViewIndex(ViewIndex));
+			}
+			else
+			{
+				// Changed only for views rendered now, as the quilt copy relies on the scales of the rendered pictures
+				const float ViewScale = bScaleViews ? GetViewResolutionScale(CurrentViewLerp) : 1.0f;
+				RenderingConfig.SetViewResolutionScale(ViewIndex, RenderingConfigs.RenderScale * ViewScale);
+			}
 		}
 
 		// Render view
 		SCOPE_CYCLE_COUNTER(STAT_CaptureScene_GameThread);
+		INC_DWORD_STAT(STAT_CaptureViewFamilies);
+		INC_DWORD_STAT_BY(STAT_CaptureViews, NumViews);
+		SET_DWORD_STAT(STAT_ViewBatchSize, RenderingConfigs.ViewBatchSize);
+		SET_FLOAT_STAT(STAT_ViewBatchMemory, RenderingConfigs.EstimatedMemoryMB);
 		CaptureLookingGlassScene(RenderingConfig);
 
 		// Do not hold TextureTarget after rendering
@@ -808,20 +1094,132 @@ void ULookingGlassSceneCaptureComponent2D::RenderViews()
 	}
 }
 
-void ULookingGlassSceneCaptureComponent2D::Render2DView(int32 SizeX, int32 SizeY)
+bool ULookingGlassSceneCaptureComponent2D::ShouldRefreshAllViews()
 {
-	SetupPostprocessing();
+	// Camera cut flag is reset by the capture, so check it before rendering anything
+	bool bRefreshAll = bCameraCutThisFrame || bFullRefreshRequested || RenderingConfigs.bNeedsFullRefresh;
 
-	const FLGDeviceCalibration& Calibration = ILookingGlassRuntime::Get().GetCurrentCalibration();
+	// Views of previous frames are visibly wrong when the camera moves fast
+	const FTransform& Transform = GetComponentToWorld();
+	const float Motion = FVector::Dist(Transform.GetTranslation(), LastRenderedTransform.GetTranslation());
+	const float Rotation = FMath::RadiansToDegrees(Transform.GetRotation().AngularDistance(LastRenderedTransform.GetRotation()));
+	bRefreshAll |= Motion > AmortizedMotionThreshold || Rotation > AmortizedRotationThreshold || Size != LastRenderedSize;
 
-	// Check if the texture is exists
-	if (TextureTarget2DRendering == nullptr)
+	LastRenderedTransform = Transform;
+	LastRenderedSize = Size;
+	bFullRefreshRequested = false;
+	RenderingConfigs.bNeedsFullRefresh = false;
+
+	return bRefreshAll;
+}
+
+float ULookingGlassSceneCaptureComponent2D::GetViewResolutionScale(float CurrentViewLerp) const
+{
+	const float Distance = FMath::Abs(CurrentViewLerp) * 2.0f;
+	const FRichCurve* ResolutionCurve = ViewResolutionCurve.GetRichCurveConst();
+	const float CurveScale = ResolutionCurve->GetNumKeys() > 0 ? ResolutionCurve->Eval(Distance) : 1.0f;
+	const float Scale = FMath::Clamp(CurveScale, MinViewResolutionScale, 1.0f);
+	return FMath::Lerp(1.0f, Scale, bViewResolutionGovernor ? ViewResolutionStrength : 1.0f);
+}
+
+void ULookingGlassSceneCaptureComponent2D::UpdateViewResolutionGovernor()
+{
+	if (!bViewResolutionGovernor)
+	{
+		return;
+	}
+
+	// GPU time of the whole frame, smoothed to avoid reacting to single spikes
+	const float GPUFrameTimeMS = FPlatformTime::ToMilliseconds(RHIGetGPUFrameCycles());
+	if (GPUFrameTimeMS <= 0.0f)
+	{
+		return;
+	}
+	AverageGPUFrameTimeMS = AverageGPUFrameTimeMS > 0.0f ? FMath::Lerp(AverageGPUFrameTimeMS, GPUFrameTimeMS, 0.1f) : GPUFrameTimeMS;
+
+	// Lower resolution quickly when over budget, raise it slowly when well below it, and stay between
+	static constexpr float StrengthStep = 0.02f;
+	if (AverageGPUFrameTimeMS > TargetFrameTimeMS)
+	{
+		ViewResolutionStrength = FMath::Min(ViewResolutionStrength + 2.0f * StrengthStep, 1.0f);
+	}
+	else if (AverageGPUFrameTimeMS < TargetFrameTimeMS * 0.85f)
+	{
+		ViewResolutionStrength = FMath::Max(ViewResolutionStrength - StrengthStep, 0.0f);
+	}
+	SET_FLOAT_STAT(STAT_ViewResolutionStrength, ViewResolutionStrength);
+}
+
+float ULookingGlassSceneCaptureComponent2D::GetTilingQualityScale() const
+{
+	if (!bTilingQualityGovernor || !TilingQualityLevels.IsValidIndex(TilingQualityLevel))
+	{
+		return 1.0f;
+	}
+	return TilingQualityLevels[TilingQualityLevel];
+}
+
+void ULookingGlassSceneCaptureComponent2D::UpdateTilingQualityGovernor()
+{
+	if (!bTilingQualityGovernor || bRenderDirectToQuilt || TilingQualityLevels.Num() == 0)
+	{
+		return;
+	}
+
+	// The slowest of game thread, rendering thread and GPU limits the frame rate
+	const float GameThreadMS = FPlatformTime::ToMilliseconds(GGameThreadTime);
+	const float RenderThreadMS = FPlatformTime::ToMilliseconds(GRenderThreadTime);
+	const float GPUMS = FPlatformTime::ToMilliseconds(RHIGetGPUFrameCycles());
+	const float FrameTimeMS = FMath::Max3(GameThreadMS, RenderThreadMS, GPUMS);
+	if (FrameTimeMS <= 0.0f)
+	{
+		return;
+	}
+	AverageFrameTimeMS = AverageFrameTimeMS > 0.0f ? FMath::Lerp(AverageFrameTimeMS, FrameTimeMS, 0.1f) : FrameTimeMS;
+
+	// The per-view governor reacts to the same GPU time, so it goes first: the level steps down only when views are
+	// already at their lowest resolution, and steps up only when they are back at full resolution.
+	const bool bViewGovernorActive = bPerViewResolution && bViewResolutionGovernor;
+	const bool bCanDowngrade = !bViewGovernorActive || ViewResolutionStrength >= 1.0f;
+	const bool bCanUpgrade = !bViewGovernorActive || ViewResolutionStrength <= 0.0f;
+
+	// Time spent over the budget or well below it. Frames in between reset both, so the level doesn't oscillate.
+	const float BudgetMS = 1000.0f / TargetFPS;
+	const float DeltaTime = FApp::GetDeltaTime();
+	OverBudgetTime = bCanDowngrade && AverageFrameTimeMS > BudgetMS ? OverBudgetTime + DeltaTime : 0.0f;
+	UnderBudgetTime = bCanUpgrade && AverageFrameTimeMS < BudgetMS * QualityUpgradeHeadroom ? UnderBudgetTime + DeltaTime : 0.0f;
+
+	int32 NewLevel = FMath::Clamp(TilingQualityLevel, 0, TilingQualityLevels.Num() - 1);
+	if (OverBudgetTime > QualityDowngradeDelay && NewLevel < TilingQualityLevels.Num() - 1)
+	{
+		NewLevel++;
+	}
+	else if (UnderBudgetTime > QualityUpgradeDelay && NewLevel > 0)
+	{
+		NewLevel--;
+	}
+
+	if (NewLevel != TilingQualityLevel)
 	{
-		TextureTarget2DRendering = NewObject<UTextureRenderTarget2D>(GetTransientPackage(), UTextureRenderTarget2D::StaticClass());
-		TextureTarget2DRendering->InitCustomFormat(Calibration.Width, Calibration.Height, PF_A16B16G16R16, false);
-		TextureTarget2DRendering->ClearColor = FLinearColor::Red;
-		TextureTarget2DRendering->UpdateResourceImmediate();
+		UE_LOG(LookingGlassLogGame, Log, TEXT("Tiling quality level %d -> %d (resolution scale %.2f), frame time %.2f ms, budget %.2f ms"),
+			TilingQualityLevel, NewLevel, TilingQualityLevels[NewLevel], AverageFrameTimeMS, BudgetMS);
+		TilingQualityLevel = NewLevel;
+		OverBudgetTime = 0.0f;
+		UnderBudgetTime = 0.0f;
+
+		// Same path as SetTilingProperties(), only the render scale of the configs changes
+		UpdateTilingProperties();
 	}
+	SET_DWORD_STAT(STAT_TilingQualityLevel, TilingQualityLevel);
+}
+
+void ULookingGlassSceneCaptureComponent2D::Render2DView(int32 SizeX, int32 SizeY)
+{
+	SetupPostprocessing();
+
+	LastRenderTime = FPlatformTime::Seconds();
+
+	const FLGDeviceCalibration& Calibration = ILookingGlassRuntime::Get().GetCurrentCalibration();
 
 	if (SizeX < 0 && SizeY < 0)
 	{
@@ -829,12 +1227,16 @@ void ULookingGlassSceneCaptureComponent2D::Render2DView(int32 SizeX, int32 SizeY
 		SizeY = Calibration.Height;
 	}
 
-	if (SizeX != TextureTarget2DRendering->SizeX || SizeY != TextureTarget2DRendering->SizeY)
+	// Lease a new target from the pool when the size or pixel format setting has been changed
+	const EPixelFormat Format = FLookingGlassRenderingConfig::GetPixelFormat(PixelFormat);
+	if (TextureTarget2DRendering != nullptr &&
+		(TextureTarget2DRendering->OverrideFormat != Format || SizeX != TextureTarget2DRendering->SizeX || SizeY != TextureTarget2DRendering->SizeY))
 	{
-		TextureTarget2DRendering->ResizeTarget(SizeX, SizeY);
-		TextureTarget2DRendering->UpdateResourceImmediate();
-		// Sync with rendering thread, in order to reset texture resolution
-		FlushRenderingCommands();
+		Release2DRenderTarget();
+	}
+	if (TextureTarget2DRendering == nullptr)
+	{
+		TextureTarget2DRendering = ILookingGlassRuntime::Get().GetRenderTargetPool().Acquire(FIntPoint(SizeX, SizeY), Format);
 	}
 
 	// Set 2D texture
@@ -850,11 +1252,61 @@ void ULookingGlassSceneCaptureComponent2D::Render2DView(int32 SizeX, int32 SizeY
 	TextureTarget = nullptr;
 }
 
+void ULookingGlassSceneCaptureComponent2D::ReduceMemoryUse()
+{
+	RenderingConfigs.ReduceMemoryUse();
+	Release2DRenderTarget();
+
+	// Render targets leased again could hold views of other components
+	RequestFullRefresh();
+}
+
+void ULookingGlassSceneCaptureComponent2D::Release2DRenderTarget()
+{
+	if (TextureTarget2DRendering != nullptr && ILookingGlassRuntime::IsAvailable())
+	{
+		ILookingGlassRuntime::Get().GetRenderTargetPool().Release(TextureTarget2DRendering);
+	}
+	TextureTarget2DRendering = nullptr;
+}
+
 
 /*
  * FLookingGlassRenderingConfig
  */
 
+EPixelFormat FLookingGlassRenderingConfig::GetPixelFormat(ELookingGlassPixelFormat PixelFormat)
+{
+	switch (PixelFormat)
+	{
+	case ELookingGlassPixelFormat::RGBA8:
+		// BGRA matches FColor, so readback doesn't need a conversion pass
+		return PF_B8G8R8A8;
+	case ELookingGlassPixelFormat::RGB10A2:
+		return PF_A2B10G10R10;
+	case ELookingGlassPixelFormat::FP16:
+	default:
+		return PF_FloatRGBA;
+	}
+}
+
+void FLookingGlassRenderingConfig::CalculateTextureLayout(const FIntPoint& ViewSize, int32 NumViews, int32& OutViewRows, int32& OutViewColumns)
+{
+	static int32 GMaxTextureDimensionsLocal = (int32)GMaxTextureDimensions;
+
+	OutViewRows = 1;
+	if (ViewSize.X * NumViews > GMaxTextureDimensionsLocal)
+	{
+		// Views don't fit into a single row of the texture, wrap them
+		int32 ViewsPerRow = GMaxTextureDimensionsLocal / FMath::Max(ViewSize.X, 1);
+		if (ViewsPerRow > 0)
+		{
+			OutViewRows = FMath::CeilToInt(float(NumViews) / float(ViewsPerRow));
+		}
+	}
+	OutViewColumns = FMath::RoundFromZero(float(NumViews) / float(OutViewRows));
+}
+
 void FLookingGlassRenderingConfig::CalculateViewRect(FIntRect& Rect, const FIntPoint& Size, int32 ViewRows, int32 ViewColumns, int32 ViewIndex)
 {
 	Rect.Min.X = (ViewIndex % ViewColumns) * Size.X;
@@ -874,10 +1326,68 @@ void FLookingGlassRenderingConfig::CalculateViewRect(float& U, float& V, float&
 	V = Row * SizeV;
 }
 
+void FLookingGlassRenderingConfig::CalculateQuiltTileRect(FIntRect& Rect, const FLookingGlassTilingQuality& TilingValues, ELookingGlassQuiltOrder QuiltOrder, int32 ViewIndex)
+{
+	// Support four scanning orders for quilt tiles
+	int32 X = 0;
+	int32 Y = 0;
+	switch (QuiltOrder)
+	{
+	case ELookingGlassQuiltOrder::TopLeft_To_BottomRight:
+	{
+		// Row-major from top-left to bottom-right
+		const int32 Row = ViewIndex / TilingValues.TilesX; // 0 is top row
+		const int32 Col = ViewIndex % TilingValues.TilesX;
+		X = Col * TilingValues.TileSizeX;
+		Y = Row * TilingValues.TileSizeY;
+		break;
+	}
+	case ELookingGlassQuiltOrder::BottomLeft_To_TopRight:
+	{
+		// Legacy behavior: bottom-left to top-right
+		const int32 RI = TilingValues.GetNumTiles() - ViewIndex - 1;
+		X = (ViewIndex % TilingValues.TilesX) * TilingValues.TileSizeX;
+		Y = (RI / TilingValues.TilesX) * TilingValues.TileSizeY;
+		break;
+	}
+	case ELookingGlassQuiltOrder::TopRight_To_BottomLeft:
+	{
+		// Row-major from top-right to bottom-left
+		const int32 Row = ViewIndex / TilingValues.TilesX; // 0 is top row
+		const int32 ColFromRight = ViewIndex % TilingValues.TilesX;
+		const int32 Col = (TilingValues.TilesX - 1) - ColFromRight;
+		X = Col * TilingValues.TileSizeX;
+		Y = Row * TilingValues.TileSizeY;
+		break;
+	}
+	case ELookingGlassQuiltOrder::BottomRight_To_TopLeft:
+	{
+		// Row-major from bottom-right to top-left
+		const int32 RowFromBottom = ViewIndex / TilingValues.TilesX;
+		const int32 Row = (TilingValues.TilesY - 1) - RowFromBottom;
+		const int32 ColFromRight = ViewIndex % TilingValues.TilesX;
+		const int32 Col = (TilingValues.TilesX - 1) - ColFromRight;
+		X = Col * TilingValues.TileSizeX;
+		Y = Row * TilingValues.TileSizeY;
+		break;
+	}
+	default:
+		break;
+	}
+
+	// The padding is necessary because the shader takes y from the opposite spot as this does
+	const int32 PaddingY = TilingValues.QuiltH - TilingValues.TilesY * TilingValues.TileSizeY;
+	Rect.Min = FIntPoint(X, Y + PaddingY);
+	Rect.Max = Rect.Min + FIntPoint(TilingValues.TileSizeX, TilingValues.TileSizeY);
+}
+
 FLookingGlassRenderingConfig::FLookingGlassRenderingConfig()
 	: RenderTarget(nullptr)
+	, bUseRenderTarget(false)
 	, FirstViewIndex(0)
 	, TextureSize(1, 1)
+	, ViewSize(1, 1)
+	, Format(PF_A16B16G16R16)
 {
 }
 
@@ -888,22 +1398,36 @@ FLookingGlassRenderingConfig::~FLookingGlassRenderingConfig()
 
 void FLookingGlassRenderingConfig::Release()
 {
-	if (RenderTarget != nullptr && RenderTarget->IsValidLowLevel())
+	if (RenderTarget != nullptr && ILookingGlassRuntime::IsAvailable())
 	{
-		RenderTarget->ConditionalBeginDestroy();
+		// Return the target to the pool, so the next config with the same size could reuse it
+		ILookingGlassRuntime::Get().GetRenderTargetPool().Release(RenderTarget);
 	}
 
 	RenderTarget = nullptr;
+	DepthCapture.Reset();
+}
+
+void FLookingGlassRenderingConfig::EnableDepthCapture()
+{
+#if WITH_LOOKINGGLASS_VIEW_SYNTHESIS
+	if (!DepthCapture.IsValid())
+	{
+		DepthCapture = FSceneViewExtensions::NewExtension<FLookingGlassDepthCapture>();
+	}
+#endif
 }
 
-void FLookingGlassRenderingConfig::Init(UObject* Parent, uint32 InMinTextureIndex, uint32 InMaxTextureIndex, const FIntPoint& InViewSize)
+void FLookingGlassRenderingConfig::Init(TArray<int32>&& InQuiltViewIndices, const FIntPoint& InViewSize, bool bAllocateRenderTarget, EPixelFormat InFormat)
 {
 	UE_LOG(LookingGlassLogGame, Log, TEXT("=== FLookingGlassRenderingConfig::Init 开始 ==="));
-	UE_LOG(LookingGlassLogGame, Log, TEXT("输入参数: InMinTextureIndex=%d, InMaxTextureIndex=%d, InViewSize=(%d,%d)"), 
-		InMinTextureIndex, InMaxTextureIndex, InViewSize.X, InViewSize.Y);
+	UE_LOG(LookingGlassLogGame, Log, TEXT("输入参数: NumQuiltViewIndices=%d, InViewSize=(%d,%d)"), 
+		InQuiltViewIndices.Num(), InViewSize.X, InViewSize.Y);
 	
-	FirstViewIndex = InMinTextureIndex;
-	NumViews = InMaxTextureIndex - InMinTextureIndex + 1;
+	QuiltViewIndices = MoveTemp(InQuiltViewIndices);
+	FirstViewIndex = QuiltViewIndices.Num() > 0 ? QuiltViewIndices[0] : 0;
+	NumViews = QuiltViewIndices.Num();
+	Format = InFormat;
 	
 	UE_LOG(LookingGlassLogGame, Log, TEXT("计算得出: FirstViewIndex=%d, NumViews=%d"), FirstViewIndex, NumViews);
 
@@ -917,59 +1441,24 @@ void FLookingGlassRenderingConfig::Init(UObject* Parent, uint32 InMinTextureInde
 		check(InViewSize.X < GMaxTextureDimensionsLocal);
 		check(InViewSize.Y < GMaxTextureDimensionsLocal);
 		
-		int32 TextureSizeX = InViewSize.X * NumViews;
-		UE_LOG(LookingGlassLogGame, Log, TEXT("计算总纹理宽度: TextureSizeX = %d * %d = %d"), InViewSize.X, NumViews, TextureSizeX);
-		
-		ViewRows = 1;
-		UE_LOG(LookingGlassLogGame, Log, TEXT("初始设置: ViewRows=%d"), ViewRows);
-		
-		if (TextureSizeX > GMaxTextureDimensionsLocal)
-		{
-			UE_LOG(LookingGlassLogGame, Log, TEXT("总纹理宽度超过限制，需要多行排列"));
-			// 计算每行能放多少个视图
-			int32 ViewsPerRow = GMaxTextureDimensionsLocal / InViewSize.X;
-			UE_LOG(LookingGlassLogGame, Log, TEXT("每行可容纳视图数: ViewsPerRow = %d / %d = %d"), 
-				GMaxTextureDimensionsLocal, InViewSize.X, ViewsPerRow);
-			
-			if (ViewsPerRow > 0)
-			{
-				// 计算需要多少行来容纳所有视图
-				ViewRows = FMath::CeilToInt(float(NumViews) / float(ViewsPerRow));
-				UE_LOG(LookingGlassLogGame, Log, TEXT("计算所需行数: ViewRows = Ceil(%d / %d) = %d"), 
-					NumViews, ViewsPerRow, ViewRows);
-			}
-		}
-		else
-		{
-			UE_LOG(LookingGlassLogGame, Log, TEXT("总纹理宽度在限制范围内，使用单行排列"));
-		}
+		CalculateTextureLayout(InViewSize, NumViews, ViewRows, ViewColumns);
+		UE_LOG(LookingGlassLogGame, Log, TEXT("视图布局: ViewRows=%d, ViewColumns=%d"), ViewRows, ViewColumns);
 
-		ViewColumns = FMath::RoundFromZero(float(NumViews) / float(ViewRows));
-		UE_LOG(LookingGlassLogGame, Log, TEXT("计算列数: ViewColumns = Round(%d / %d) = %d"), NumViews, ViewRows, ViewColumns);
-		
 		TextureSize.X = InViewSize.X * ViewColumns;
 		TextureSize.Y = InViewSize.Y * ViewRows;
 		UE_LOG(LookingGlassLogGame, Log, TEXT("最终纹理尺寸: TextureSize=(%d,%d)"), TextureSize.X, TextureSize.Y);
 		UE_LOG(LookingGlassLogGame, Log, TEXT("视图排列: %d行 x %d列，总共%d个视图"), ViewRows, ViewColumns, NumViews);
 
-		const FName TargetName = MakeUniqueObjectName(Parent, UTextureRenderTarget2D::StaticClass());
-		UE_LOG(LookingGlassLogGame, Log, TEXT("创建渲染目标: TargetName=%s"), *TargetName.ToString());
-		
-		// Make a new UTextureRenderTarget2D object. Note: adding RF_TextExportTransient to not let it go to Copy or Duplicate
-		// operation, as this object will be regenerated by C++ code anyway. Plus, it bypasses a warning in UTextureRenderTarget2D::PostEditChangeProperty
-		// saying (for each render target) that RT is very large and performance will be poor.
-		RenderTarget = NewObject<UTextureRenderTarget2D>(Parent, TargetName, RF_Transient | RF_Transactional | RF_TextExportTransient);
-		UE_LOG(LookingGlassLogGame, Log, TEXT("渲染目标对象创建成功"));
-		
-		// Initialize with 1x1 texture. Resolution will be changed later, dynamically (in PrepareRT())
-		RenderTarget->InitCustomFormat(1, 1, PF_A16B16G16R16, false);
-		UE_LOG(LookingGlassLogGame, Log, TEXT("渲染目标初始化: 格式=PF_A16B16G16R16, 尺寸=1x1"));
-		
-		RenderTarget->ClearColor = FLinearColor::Red;
-		RenderTarget->UpdateResourceImmediate();
-		UE_LOG(LookingGlassLogGame, Log, TEXT("渲染目标设置清除颜色为红色并更新资源"));
+		// The render target is leased from the runtime's pool in PrepareRT(), so it won't take any space until rendering starts
+		bUseRenderTarget = bAllocateRenderTarget;
+		if (!bUseRenderTarget)
+		{
+			UE_LOG(LookingGlassLogGame, Log, TEXT("直接渲染到Quilt: 不创建中间渲染目标"));
+		}
 
 		ViewInfoArr.AddZeroed(NumViews);
+		ViewSize = InViewSize;
+		ViewScales.Init(FVector2f(1.0f, 1.0f), NumViews);
 		UE_LOG(LookingGlassLogGame, Log, TEXT("创建视图信息数组: ViewInfoArr.Num()=%d"), ViewInfoArr.Num());
 		
 		for (int32 CaptureIndex = 0; CaptureIndex < ViewInfoArr.Num(); ++CaptureIndex)
@@ -994,11 +1483,22 @@ void FLookingGlassRenderingConfig::Init(UObject* Parent, uint32 InMinTextureInde
 	else
 	{
 		UE_LOG(LookingGlassLogGame, Warning, TEXT("错误: NumViews <= 0, 输入参数无效"));
-		UE_LOG(LookingGlassLogGame, Warning, TEXT("InMinTextureIndex=%d, InMaxTextureIndex=%d, 计算得出NumViews=%d"), 
-			InMinTextureIndex, InMaxTextureIndex, NumViews);
+		UE_LOG(LookingGlassLogGame, Warning, TEXT("计算得出NumViews=%d"), NumViews);
 	}
 }
 
+void FLookingGlassRenderingConfig::SetViewResolutionScale(int32 ViewIndex, float Scale)
+{
+	FIntRect FullRect;
+	CalculateViewRect(FullRect, ViewSize, ViewRows, ViewColumns, ViewIndex);
+
+	const FIntPoint ScaledSize(
+		FMath::Clamp(FMath::RoundToInt(ViewSize.X * Scale), 1, ViewSize.X),
+		FMath::Clamp(FMath::RoundToInt(ViewSize.Y * Scale), 1, ViewSize.Y));
+	ViewInfoArr[ViewIndex].ViewRect = FIntRect(FullRect.Min, FullRect.Min + ScaledSize);
+	ViewScales[ViewIndex] = FVector2f((float)ScaledSize.X / ViewSize.X, (float)ScaledSize.Y / ViewSize.Y);
+}
+
 void FLookingGlassRenderingConfig::AddReferencedObjects(FReferenceCollector& Collector)
 {
 	if (RenderTarget != nullptr)
@@ -1009,14 +1509,18 @@ void FLookingGlassRenderingConfig::AddReferencedObjects(FReferenceCollector& Col
 
 void FLookingGlassRenderingConfig::PrepareRT()
 {
-	check(RenderTarget != nullptr);
-	RenderTarget->ResizeTarget(TextureSize.X, TextureSize.Y);
+	if (bUseRenderTarget && RenderTarget == nullptr)
+	{
+		RenderTarget = ILookingGlassRuntime::Get().GetRenderTargetPool().Acquire(TextureSize, Format);
+	}
 }
 
 void FLookingGlassRenderingConfig::ReduceMemoryUse()
 {
 	if (RenderTarget != nullptr)
 	{
-		RenderTarget->ResizeTarget(1, 1);
+		// Leased again by PrepareRT(), pooled targets are freed when they stay idle
+		ILookingGlassRuntime::Get().GetRenderTargetPool().Release(RenderTarget);
+		RenderTarget = nullptr;
 	}
 }
@@ -1,8 +1,15 @@
 #include "LookingGlassBridge.h"
+#include "ILookingGlassRuntime.h"
 
 #include "HAL/PlatformMisc.h"
 #include "HAL/PlatformProcess.h"
 #include "HAL/FileManager.h"
+#include "Async/Async.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
 
 #if WITH_EDITOR
 #include "Framework/Application/SlateApplication.h"
@@ -12,6 +19,10 @@
 
 #include "DynamicRHI.h"
 
+// WITH_LOOKINGGLASS_BRIDGE is set by LookingGlassRuntime.Build.cs. Bridge is used on Windows only, on other platforms
+// Initialize() fails and the default calibration is used, so headless tools like the image encoder benchmark still run.
+#if WITH_LOOKINGGLASS_BRIDGE
+
 // "bridge.h" includes windows headers, which aren't compliant with Unreal's strict coding standard - we should disable something first
 THIRD_PARTY_INCLUDES_START
 #pragma warning(push)
@@ -33,6 +44,8 @@ THIRD_PARTY_INCLUDES_END
 #undef GetClassName
 #undef max
 
+#endif // WITH_LOOKINGGLASS_BRIDGE
+
 // 编译开关：设置为1禁用LookingGlass设备检测
 #define DISABLE_LOOKINGGLASS_DEVICE_DETECTION 1
 
@@ -44,17 +57,23 @@ DEFINE_LOG_CATEGORY_STATIC(LogLookingGlassBridge, Log, All);
 
 #define LOCTEXT_NAMESPACE "LookingGlassBridge"
 
+#if WITH_LOOKINGGLASS_BRIDGE
 static void ReportError(const FString& Message)
 {
 	UE_LOG(LogLookingGlassBridge, Error, TEXT("%s"), *Message);
 #if WITH_EDITOR
-	FNotificationInfo Info(FText::FromString(Message));
-	Info.ExpireDuration = 15.0f;
-	Info.bUseSuccessFailIcons = true;
-	Info.Image = FAppStyle::GetBrush(TEXT("MessageLog.Warning"));
-	TSharedPtr<SNotificationItem> NotificationItem = FSlateNotificationManager::Get().AddNotification(Info);
+	// Bridge is initialized on a worker thread, while notifications are shown by Slate on the game thread
+	AsyncTask(ENamedThreads::GameThread, [Message]()
+		{
+			FNotificationInfo Info(FText::FromString(Message));
+			Info.ExpireDuration = 15.0f;
+			Info.bUseSuccessFailIcons = true;
+			Info.Image = FAppStyle::GetBrush(TEXT("MessageLog.Warning"));
+			TSharedPtr<SNotificationItem> NotificationItem = FSlateNotificationManager::Get().AddNotification(Info);
+		});
 #endif // WITH_EDITOR
 }
+#endif // WITH_LOOKINGGLASS_BRIDGE
 
 bool FLookingGlassBridge::Initialize()
 {
@@ -65,6 +84,10 @@ bool FLookingGlassBridge::Initialize()
 	UE_LOG(LogTemp, Log, TEXT("LookingGlassBridge::Initialize() called"));
 	UE_LOG(LogLookingGlassBridge, Log, TEXT("LookingGlassBridge::Initialize() called"));
 	
+#if !WITH_LOOKINGGLASS_BRIDGE
+	UE_LOG(LogLookingGlassBridge, Log, TEXT("Looking Glass Bridge isn't supported on this platform, using the default calibration"));
+	return false;
+#else
 	// Load the Bridge
 	BridgeController = new ControllerWithCalibrationTemplates();
 	if (!BridgeController->Initialize(TEXT("UnrealEnginePlugin")))
@@ -91,12 +114,47 @@ bool FLookingGlassBridge::Initialize()
 	}
 
 	bInitialized = true;
+	BridgeVersion = Version;
 
-	int32 TemplateCount;
-	BridgeController->GetCalibrationTemplateCount(&TemplateCount);
+	TArray<FLGDeviceCalibration> NewTemplates, NewDisplays;
+	if (LoadCache(ReadDisplaySerials(), NewTemplates, NewDisplays))
+	{
+		// Calibration of the previous run is used right away, and compared with Bridge in the background
+		QueueCalibration(CopyTemp(NewTemplates), CopyTemp(NewDisplays), false);
+		RevalidateCache(NewTemplates, NewDisplays);
+	}
+	else
+	{
+		ReadCalibrationTemplates(NewTemplates);
+		ReadDisplays(NewDisplays);
+		QueueCalibration(MoveTemp(NewTemplates), CopyTemp(NewDisplays), true);
+	}
+
+	if (NewDisplays.Num() == 0)
+	{
+		ReportError(TEXT("No Looking Glass displays found"));
+	}
+
+	return true;
+#endif // WITH_LOOKINGGLASS_BRIDGE
+}
+
+void FLookingGlassBridge::ReadCalibrationTemplates(TArray<FLGDeviceCalibration>& OutTemplates)
+{
+	OutTemplates.Empty();
+
+#if WITH_LOOKINGGLASS_BRIDGE
+	int32 TemplateCount = 0;
+	{
+		FScopeLock Lock(&ControllerLock);
+		BridgeController->GetCalibrationTemplateCount(&TemplateCount);
+	}
 
 	for (int32 TemplateIndex = 0; TemplateIndex < TemplateCount; TemplateIndex++)
 	{
+		// Locked per template, so presenting a frame doesn't wait for the whole read
+		FScopeLock Lock(&ControllerLock);
+
 		// Note: functions which returns strings doesn't null-terminate them.
 		int32 CharsCount1 = 256, CharsCount2 = 256, CharsCount3 = 256;
 		TCHAR Buffer1[256], Buffer2[256], Buffer3[256];
@@ -116,48 +174,113 @@ bool FLookingGlassBridge::Initialize()
 			continue;
 		}
 
-		FLGDeviceCalibration& Calibration = CalibrationTemplates.AddDefaulted_GetRef();
+		FLGDeviceCalibration& Calibration = OutTemplates.AddDefaulted_GetRef();
 		Calibration.Name = Buffer2;
 		Calibration.Serial = Buffer3;
 
 		UE_LOG(LogLookingGlassBridge, Display, TEXT("Template %d: CfgVersion: %s, DeviceName: %s, Serial: %s"), TemplateIndex, Buffer1, Buffer2, Buffer3);
 
-		// We should initialize values with zeros, because in some cases values aren't changed at all
-		int InvView = 0, CellPatternMode = 0, NumberOfCells = 0;
-		float Fringe = 0;
-		BridgeController->GetCalibrationTemplate(
-			TemplateIndex,
-			&Calibration.Center,
-			&Calibration.Pitch,
-			&Calibration.Slope,
-			&Calibration.Width,
-			&Calibration.Height,
-			&Calibration.DPI,
-			&Calibration.FlipX,
-			&InvView,
-			&Calibration.ViewCone,
-			&Fringe,
-			&CellPatternMode,
-			&NumberOfCells, nullptr);
+		// We should initialize values with zeros, because in some cases values aren't changed at all. Subpixel
+		// cells are read with a second call, once their number is known.
+		int NumberOfCells = 0;
+		for (int32 Pass = 0; Pass < 2; Pass++)
+		{
+			BridgeController->GetCalibrationTemplate(
+				TemplateIndex,
+				&Calibration.Center,
+				&Calibration.Pitch,
+				&Calibration.Slope,
+				&Calibration.Width,
+				&Calibration.Height,
+				&Calibration.DPI,
+				&Calibration.FlipX,
+				&Calibration.InvView,
+				&Calibration.ViewCone,
+				&Calibration.Fringe,
+				&Calibration.CellPatternMode,
+				&NumberOfCells,
+				Pass == 0 ? nullptr : (CalibrationSubpixelCell*)Calibration.SubpixelCells.GetData());
+			if (Pass > 0 || NumberOfCells <= 0)
+			{
+				break;
+			}
+			Calibration.SubpixelCells.SetNumZeroed(NumberOfCells);
+		}
 		UE_LOG(LogLookingGlassBridge, Display, TEXT("  Center=%g, Pitch=%g, Slope=%g, DPI=%g, FlipX=%g, Width=%d, Height=%d, Aspect=%g"),
 			Calibration.Center, Calibration.Pitch, Calibration.Slope, Calibration.DPI, Calibration.FlipX, Calibration.Width, Calibration.Height, Calibration.Aspect);
 	}
+#endif // WITH_LOOKINGGLASS_BRIDGE
+}
 
-	ReadDisplays();
+void FLookingGlassBridge::ReadDisplays()
+{
+	TArray<FLGDeviceCalibration> NewDisplays;
+	ReadDisplays(NewDisplays);
+	QueueCalibration(NullOpt, MoveTemp(NewDisplays), true);
+}
 
-	if (Displays.Num() == 0)
+void FLookingGlassBridge::QueueCalibration(TOptional<TArray<FLGDeviceCalibration>> NewTemplates, TOptional<TArray<FLGDeviceCalibration>> NewDisplays, bool bSaveCache)
+{
 	{
-		ReportError(TEXT("No Looking Glass displays found"));
+		FScopeLock Lock(&PendingLock);
+		if (NewTemplates.IsSet())
+		{
+			PendingTemplates = MoveTemp(NewTemplates);
+		}
+		if (NewDisplays.IsSet())
+		{
+			PendingDisplays = MoveTemp(NewDisplays);
+		}
+		bPendingSave |= bSaveCache;
 	}
 
+	AsyncTask(ENamedThreads::GameThread, []()
+		{
+			if (ILookingGlassRuntime::IsAvailable())
+			{
+				ILookingGlassRuntime::Get().GetBridge().PublishCalibration();
+			}
+		});
+}
+
+bool FLookingGlassBridge::PublishCalibration()
+{
+	check(IsInGameThread());
+
+	bool bSave = false;
+	{
+		FScopeLock Lock(&PendingLock);
+		if (!PendingTemplates.IsSet() && !PendingDisplays.IsSet())
+		{
+			return false;
+		}
+		if (PendingTemplates.IsSet())
+		{
+			CalibrationTemplates = MoveTemp(PendingTemplates.GetValue());
+			PendingTemplates.Reset();
+		}
+		if (PendingDisplays.IsSet())
+		{
+			Displays = MoveTemp(PendingDisplays.GetValue());
+			PendingDisplays.Reset();
+		}
+		bSave = bPendingSave;
+		bPendingSave = false;
+	}
+
+	if (bSave)
+	{
+		SaveCache();
+	}
+	OnDisplaysChanged.Broadcast();
 	return true;
 }
 
-void FLookingGlassBridge::ReadDisplays()
+void FLookingGlassBridge::ReadDisplays(TArray<FLGDeviceCalibration>& OutDisplays)
 {
-	Displays.Empty();
+	OutDisplays.Empty();
 
-#if DISABLE_LOOKINGGLASS_DEVICE_DETECTION
+#if DISABLE_LOOKINGGLASS_DEVICE_DETECTION || !WITH_LOOKINGGLASS_BRIDGE
 	// 通过编译开关禁用设备检测
 	return;
 #else
@@ -166,24 +289,30 @@ void FLookingGlassBridge::ReadDisplays()
 		return;
 	}
 
-	int32 NumDisplays = 0;
-	BridgeController->GetDisplays(&NumDisplays, nullptr);
-	if (NumDisplays == 0)
+	TArray<unsigned long> DisplayIds;
 	{
-		return;
-	}
+		FScopeLock Lock(&ControllerLock);
+		int32 NumDisplays = 0;
+		BridgeController->GetDisplays(&NumDisplays, nullptr);
+		if (NumDisplays == 0)
+		{
+			return;
+		}
 
-	TArray<unsigned long> DisplayIds;
-	DisplayIds.SetNumZeroed(NumDisplays);
-	BridgeController->GetDisplays(&NumDisplays, DisplayIds.GetData());
+		DisplayIds.SetNumZeroed(NumDisplays);
+		BridgeController->GetDisplays(&NumDisplays, DisplayIds.GetData());
+	}
 
-	Displays.Empty(NumDisplays);
+	OutDisplays.Empty(DisplayIds.Num());
 
 	for (unsigned long DisplayId : DisplayIds)
 	{
+		// Locked per display, so presenting a frame doesn't wait for the whole enumeration
+		FScopeLock Lock(&ControllerLock);
+
 		const int32 BufferSize = 256;
 		TCHAR Buffer[BufferSize];
-		FLGDeviceCalibration& Display = Displays.AddDefaulted_GetRef();
+		FLGDeviceCalibration& Display = OutDisplays.AddDefaulted_GetRef();
 
 		int32 TempInt = BufferSize;
 		BridgeController->GetDeviceSerialForDisplay(DisplayId, &TempInt, Buffer);
@@ -193,43 +322,227 @@ void FLookingGlassBridge::ReadDisplays()
 		BridgeController->GetDeviceNameForDisplay(DisplayId, &TempInt, Buffer);
 		Display.Name = Buffer;
 
-		int InvView = 0, CellPatternMode = 0, NumberOfCells = 0;
-		float Fringe = 0;
-		BridgeController->GetCalibrationForDisplay(DisplayId,
-			&Display.Center,
-			&Display.Pitch,
-			&Display.Slope,
-			&Display.Width,
-			&Display.Height,
-			&Display.DPI,
-			&Display.FlipX,
-			&InvView,
-			&Display.ViewCone,
-			&Fringe,
-			&CellPatternMode,
-			&NumberOfCells,
-			nullptr);
+		int NumberOfCells = 0;
+		for (int32 Pass = 0; Pass < 2; Pass++)
+		{
+			BridgeController->GetCalibrationForDisplay(DisplayId,
+				&Display.Center,
+				&Display.Pitch,
+				&Display.Slope,
+				&Display.Width,
+				&Display.Height,
+				&Display.DPI,
+				&Display.FlipX,
+				&Display.InvView,
+				&Display.ViewCone,
+				&Display.Fringe,
+				&Display.CellPatternMode,
+				&NumberOfCells,
+				Pass == 0 ? nullptr : (CalibrationSubpixelCell*)Display.SubpixelCells.GetData());
+			if (Pass > 0 || NumberOfCells <= 0)
+			{
+				break;
+			}
+			Display.SubpixelCells.SetNumZeroed(NumberOfCells);
+		}
 
 		BridgeController->GetDisplayAspectForDisplay(DisplayId, &Display.Aspect);
+
+		long PositionX = 0, PositionY = 0;
+		if (BridgeController->GetWindowPositionForDisplay(DisplayId, &PositionX, &PositionY))
+		{
+			Display.WindowPosition = FIntPoint(PositionX, PositionY);
+		}
+	}
+#endif
+}
+
+TArray<FString> FLookingGlassBridge::ReadDisplaySerials()
+{
+	TArray<FString> Serials;
+
+#if !DISABLE_LOOKINGGLASS_DEVICE_DETECTION && WITH_LOOKINGGLASS_BRIDGE
+	if (BridgeController == nullptr)
+	{
+		return Serials;
+	}
+
+	FScopeLock Lock(&ControllerLock);
+	int32 NumDisplays = 0;
+	BridgeController->GetDisplays(&NumDisplays, nullptr);
+	if (NumDisplays == 0)
+	{
+		return Serials;
+	}
+
+	TArray<unsigned long> DisplayIds;
+	DisplayIds.SetNumZeroed(NumDisplays);
+	BridgeController->GetDisplays(&NumDisplays, DisplayIds.GetData());
+
+	for (unsigned long DisplayId : DisplayIds)
+	{
+		const int32 BufferSize = 256;
+		TCHAR Buffer[BufferSize];
+		int32 TempInt = BufferSize;
+		BridgeController->GetDeviceSerialForDisplay(DisplayId, &TempInt, Buffer);
+		Serials.Add(Buffer);
 	}
 #endif
+
+	return Serials;
+}
+
+// Bump when the layout of FLGDeviceCalibration or of the cache header changes
+static const int32 CalibrationCacheVersion = 2;
+static const uint32 CalibrationCacheMagic = 0x4C474342; // "LGCB"
+
+static FString GetCalibrationCachePath()
+{
+	return FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("LookingGlass"), TEXT("BridgeCalibration.bin"));
+}
+
+static void SerializeCalibrationCache(FArchive& Ar, int32 BridgeVersion, TArray<FLGDeviceCalibration>& Templates, TArray<FLGDeviceCalibration>& Displays)
+{
+	uint32 Magic = CalibrationCacheMagic;
+	int32 CacheVersion = CalibrationCacheVersion;
+	Ar << Magic << CacheVersion << BridgeVersion;
+
+	// Serials of the connected devices are a part of the key, so a device swapped between runs isn't shown with
+	// the calibration of the previous one
+	TArray<FString> Serials;
+	for (const FLGDeviceCalibration& Display : Displays)
+	{
+		Serials.Add(Display.Serial);
+	}
+	Ar << Serials;
+
+	Ar << Templates << Displays;
+}
+
+bool FLookingGlassBridge::LoadCache(const TArray<FString>& DisplaySerials, TArray<FLGDeviceCalibration>& OutTemplates, TArray<FLGDeviceCalibration>& OutDisplays)
+{
+	TArray<uint8> Data;
+	if (!FFileHelper::LoadFileToArray(Data, *GetCalibrationCachePath(), FILEREAD_Silent))
+	{
+		return false;
+	}
+
+	// Check the header first, arrays of an older layout can't be read
+	FMemoryReader Reader(Data);
+	uint32 Magic = 0;
+	int32 CacheVersion = 0, CachedBridgeVersion = 0;
+	Reader << Magic << CacheVersion << CachedBridgeVersion;
+	if (Reader.IsError() || Magic != CalibrationCacheMagic || CacheVersion != CalibrationCacheVersion || CachedBridgeVersion != BridgeVersion)
+	{
+		UE_LOG(LogLookingGlassBridge, Log, TEXT("Calibration cache is outdated, reading calibration from Bridge"));
+		return false;
+	}
+
+	TArray<FString> CachedSerials;
+	Reader << CachedSerials;
+	if (Reader.IsError() || CachedSerials != DisplaySerials)
+	{
+		UE_LOG(LogLookingGlassBridge, Log, TEXT("Connected devices differ from the cached ones, reading calibration from Bridge"));
+		return false;
+	}
+
+	TArray<FLGDeviceCalibration> CachedTemplates, CachedDisplays;
+	Reader << CachedTemplates << CachedDisplays;
+	if (Reader.IsError())
+	{
+		UE_LOG(LogLookingGlassBridge, Warning, TEXT("Calibration cache is corrupted, reading calibration from Bridge"));
+		return false;
+	}
+
+	OutTemplates = MoveTemp(CachedTemplates);
+	OutDisplays = MoveTemp(CachedDisplays);
+	UE_LOG(LogLookingGlassBridge, Display, TEXT("Loaded %d calibration templates and %d displays from cache"), OutTemplates.Num(), OutDisplays.Num());
+	return true;
+}
+
+void FLookingGlassBridge::SaveCache()
+{
+	// Serialize a snapshot here, the file is written on a worker. Writes go through a pipe, so an older snapshot
+	// never overwrites a newer one.
+	TArray<uint8> Data;
+	FMemoryWriter Writer(Data);
+	SerializeCalibrationCache(Writer, BridgeVersion, CalibrationTemplates, Displays);
+
+	CacheWrite = CacheWritePipe.Launch(TEXT("LookingGlassSaveCalibrationCache"), [Data = MoveTemp(Data)]()
+		{
+			if (!FFileHelper::SaveArrayToFile(Data, *GetCalibrationCachePath()))
+			{
+				UE_LOG(LogLookingGlassBridge, Warning, TEXT("Failed to write calibration cache %s"), *GetCalibrationCachePath());
+			}
+		});
+}
+
+void FLookingGlassBridge::RevalidateCache(TArray<FLGDeviceCalibration>& CachedTemplates, TArray<FLGDeviceCalibration>& CachedDisplays)
+{
+	TArray<uint8> CachedData;
+	FMemoryWriter Writer(CachedData);
+	SerializeCalibrationCache(Writer, BridgeVersion, CachedTemplates, CachedDisplays);
+
+	Revalidation = Async(EAsyncExecution::ThreadPool, [this, CachedData = MoveTemp(CachedData)]()
+		{
+			// The controller lives until Shutdown(), which waits for this task. Reads lock it per Bridge call.
+			if (BridgeController == nullptr)
+			{
+				return;
+			}
+			TArray<FLGDeviceCalibration> NewTemplates, NewDisplays;
+			ReadCalibrationTemplates(NewTemplates);
+			ReadDisplays(NewDisplays);
+
+			TArray<uint8> NewData;
+			FMemoryWriter NewWriter(NewData);
+			SerializeCalibrationCache(NewWriter, BridgeVersion, NewTemplates, NewDisplays);
+			if (NewData == CachedData)
+			{
+				UE_LOG(LogLookingGlassBridge, Log, TEXT("Calibration cache is up to date"));
+				return;
+			}
+
+			// Devices or their calibration have changed since the cache was written
+			UE_LOG(LogLookingGlassBridge, Display, TEXT("Calibration has changed since the last run, updating the cache"));
+			QueueCalibration(MoveTemp(NewTemplates), MoveTemp(NewDisplays), true);
+		});
 }
 
 void FLookingGlassBridge::Shutdown()
 {
+	// The background check uses the controller
+	if (Revalidation.IsValid())
+	{
+		Revalidation.Wait();
+	}
+
+	if (CacheWrite.IsValid())
+	{
+		CacheWrite.Wait();
+	}
+
+	FScopeLock Lock(&ControllerLock);
+	bInitialized = false;
+#if WITH_LOOKINGGLASS_BRIDGE
 	if (BridgeController != nullptr)
 	{
 		BridgeController->Uninitialize();
 		delete BridgeController;
 		BridgeController = nullptr;
 	}
+#endif
 }
 
+#if WITH_LOOKINGGLASS_BRIDGE
+
 static_assert(sizeof(int32) == sizeof(WINDOW_HANDLE));
+static_assert(sizeof(FLGSubpixelCell) == sizeof(CalibrationSubpixelCell));
 
 void FLookingGlassBridge::StartRendering()
 {
 	check(bInitialized);
+	FScopeLock Lock(&ControllerLock);
 
 	//todo: DeviceIndex - pass it as 4th param of instance_window_dx()
 	if (LGWindow == NoWindow)
@@ -245,12 +558,13 @@ void FLookingGlassBridge::StartRendering()
 void FLookingGlassBridge::StopRendering()
 {
 	check(bInitialized);
+	FScopeLock Lock(&ControllerLock);
 
-	if (TextureRegistered != nullptr)
+	for (void* Texture : RegisteredTextures)
 	{
-		BridgeController->UnregisterTextureDX(LGWindow, (IUnknown*)TextureRegistered);
-		TextureRegistered = nullptr;
+		BridgeController->UnregisterTextureDX(LGWindow, (IUnknown*)Texture);
 	}
+	RegisteredTextures.Empty();
 	if (LGWindow != NoWindow)
 	{
 		BridgeController->ShowWindow(LGWindow, false);
@@ -260,21 +574,47 @@ void FLookingGlassBridge::StopRendering()
 void FLookingGlassBridge::DrawTexture(void* Texture, int32 QuiltDX, int32 QuiltDY, float Aspect)
 {
 	check(bInitialized);
+	FScopeLock Lock(&ControllerLock);
 
-	// Just in case - check if there's already a registered texture
-	if (TextureRegistered != Texture && TextureRegistered != nullptr)
+	// Register the texture once, and keep it registered while it is alive: the quilt ring textures are presented in turn
+	if (!RegisteredTextures.Contains(Texture))
 	{
-		BridgeController->UnregisterTextureDX(LGWindow, (IUnknown*)TextureRegistered);
-		TextureRegistered = nullptr;
+		BridgeController->RegisterTextureDX(LGWindow, (IUnknown*)Texture);
+		RegisteredTextures.Add(Texture);
 	}
 
-	if (TextureRegistered == nullptr)
+	BridgeController->DrawInteropQuiltTextureDX(LGWindow, (IUnknown*)Texture, QuiltDX, QuiltDY, Aspect, 1.0f);
+}
+
+void FLookingGlassBridge::UnregisterTexture(void* Texture)
+{
+	FScopeLock Lock(&ControllerLock);
+	if (bInitialized && RegisteredTextures.Remove(Texture) > 0)
 	{
-		BridgeController->RegisterTextureDX(LGWindow, (IUnknown*)Texture);
-		TextureRegistered = Texture;
+		BridgeController->UnregisterTextureDX(LGWindow, (IUnknown*)Texture);
 	}
+}
+
+#else // WITH_LOOKINGGLASS_BRIDGE
+
+// Never initialized without Bridge, so presenting is never started
+
+void FLookingGlassBridge::StartRendering()
+{
+}
 
-	BridgeController->DrawInteropQuiltTextureDX(LGWindow, (IUnknown*)TextureRegistered, QuiltDX, QuiltDY, Aspect, 1.0f);
+void FLookingGlassBridge::StopRendering()
+{
+}
+
+void FLookingGlassBridge::DrawTexture(void* Texture, int32 QuiltDX, int32 QuiltDY, float Aspect)
+{
 }
 
+void FLookingGlassBridge::UnregisterTexture(void* Texture)
+{
+}
+
+#endif // WITH_LOOKINGGLASS_BRIDGE
+
 #undef LOCTEXT_NAMESPACE
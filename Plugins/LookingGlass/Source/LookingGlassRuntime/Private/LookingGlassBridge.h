@@ -1,6 +1,28 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Async/Future.h"
+#include "HAL/CriticalSection.h"
+#include "Tasks/Pipe.h"
+
+#include <atomic>
+
+// Position of the red, green and blue subpixels inside a pixel, in pixels, for panels without a plain RGB stripe.
+// Same layout as CalibrationSubpixelCell of Bridge.
+struct FLGSubpixelCell
+{
+	float ROffsetX = 0;
+	float ROffsetY = 0;
+	float GOffsetX = 0;
+	float GOffsetY = 0;
+	float BOffsetX = 0;
+	float BOffsetY = 0;
+
+	friend FArchive& operator<<(FArchive& Ar, FLGSubpixelCell& Cell)
+	{
+		return Ar << Cell.ROffsetX << Cell.ROffsetY << Cell.GOffsetX << Cell.GOffsetY << Cell.BOffsetX << Cell.BOffsetY;
+	}
+};
 
 struct FLGDeviceCalibration
 {
@@ -18,6 +40,25 @@ struct FLGDeviceCalibration
 	int32 Height = 0;
 	float Aspect = 0;
 	float ViewCone = 0;
+	int32 InvView = 0;
+	float Fringe = 0;
+
+	// Subpixel layout, empty for RGB stripe panels. Non-zero CellPatternMode repeats the cells over the panel.
+	int32 CellPatternMode = 0;
+	TArray<FLGSubpixelCell> SubpixelCells;
+
+	// Top-left corner of the panel on the desktop
+	FIntPoint WindowPosition = FIntPoint::ZeroValue;
+
+	// Used by the calibration cache, see FLookingGlassBridge::LoadCache()
+	friend FArchive& operator<<(FArchive& Ar, FLGDeviceCalibration& Calibration)
+	{
+		Ar << Calibration.Name << Calibration.Serial;
+		Ar << Calibration.Center << Calibration.Pitch << Calibration.Slope << Calibration.DPI << Calibration.FlipX;
+		Ar << Calibration.Width << Calibration.Height << Calibration.Aspect << Calibration.ViewCone;
+		Ar << Calibration.InvView << Calibration.Fringe << Calibration.CellPatternMode << Calibration.SubpixelCells;
+		return Ar << Calibration.WindowPosition;
+	}
 };
 
 struct FLookingGlassBridge
@@ -31,7 +72,7 @@ public:
 
 	bool IsRendering()
 	{
-		return (TextureRegistered != nullptr);
+		return (RegisteredTextures.Num() > 0);
 	}
 
 	void StartRendering();
@@ -40,18 +81,74 @@ public:
 
 	void DrawTexture(void* Texture, int32 QuiltDX, int32 QuiltDY, float Aspect);
 
-	bool bInitialized = false;
+	// Forget a texture passed to DrawTexture before, should be called before the texture is released
+	void UnregisterTexture(void* Texture);
+
+	// Moves calibration read on worker threads into Displays and CalibrationTemplates, and broadcasts OnDisplaysChanged.
+	// Called on the game thread, returns false if there was nothing new.
+	bool PublishCalibration();
 
+	// Set on the Bridge worker thread, read by the game and render threads
+	std::atomic<bool> bInitialized = false;
+
+	// Displays and templates are owned by the game thread, workers hand their reads over with PublishCalibration()
 	TArray<FLGDeviceCalibration> Displays;
 
 	TArray<FLGDeviceCalibration> CalibrationTemplates;
 
+	// Called on the game thread when new calibration is published: after displays are enumerated, or when the
+	// background check finds that calibration differs from the cached one
+	FSimpleMulticastDelegate OnDisplaysChanged;
+
 protected:
+	void ReadCalibrationTemplates(TArray<FLGDeviceCalibration>& OutTemplates);
+
+	void ReadDisplays(TArray<FLGDeviceCalibration>& OutDisplays);
+
+	// Serials of the connected devices, a cheap read compared to the whole calibration
+	TArray<FString> ReadDisplaySerials();
+
+	// Calibration templates and displays are cached in Saved/LookingGlass, so startup doesn't wait for the Bridge
+	// round-trips. The cache is valid for the same Bridge version and the same connected devices only.
+	bool LoadCache(const TArray<FString>& DisplaySerials, TArray<FLGDeviceCalibration>& OutTemplates, TArray<FLGDeviceCalibration>& OutDisplays);
+
+	// Called on the game thread, writes the file in the background
+	void SaveCache();
+
+	// Reads calibration from Bridge on a worker thread, and replaces the cached one when it differs
+	void RevalidateCache(TArray<FLGDeviceCalibration>& CachedTemplates, TArray<FLGDeviceCalibration>& CachedDisplays);
+
+	int32 BridgeVersion = 0;
+
+	// Serializes calls to Bridge between the game thread and the background check. Reads on worker threads take it per
+	// template or display, so they don't stall presenting for the whole read.
+	FCriticalSection ControllerLock;
+
+	TFuture<void> Revalidation;
+
+	UE::Tasks::FPipe CacheWritePipe{ TEXT("LookingGlassCalibrationCache") };
+
+	// The last cache write, Shutdown() waits for it
+	UE::Tasks::FTask CacheWrite;
+
+	// Stores calibration read on a worker thread, and schedules PublishCalibration() on the game thread. Unset
+	// arrays leave the published ones as they are.
+	void QueueCalibration(TOptional<TArray<FLGDeviceCalibration>> NewTemplates, TOptional<TArray<FLGDeviceCalibration>> NewDisplays, bool bSaveCache);
+
+	FCriticalSection PendingLock;
+
+	TOptional<TArray<FLGDeviceCalibration>> PendingTemplates;
+
+	TOptional<TArray<FLGDeviceCalibration>> PendingDisplays;
+
+	bool bPendingSave = false;
+
 	static const uint32 NoWindow = 0xffffffff;
 
 	uint32 LGWindow = NoWindow;
 
-	void* TextureRegistered = nullptr;
+	// Textures registered in Bridge. There could be several of them when quilt frames are pipelined.
+	TArray<void*, TInlineAllocator<4>> RegisteredTextures;
 
 	class ControllerWithCalibrationTemplates* BridgeController = nullptr;
 };
@@ -6,6 +6,7 @@
 #include "Render/SLookingGlassViewport.h"
 
 #include "Render/LookingGlassViewportClient.h"
+#include "Render/LookingGlassInterleaver.h"
 
 #include "Game/LookingGlassCapture.h"
 
@@ -15,6 +16,7 @@
 
 #include "Managers/LookingGlassCommandLineManager.h"
 #include "Managers/LookingGlassLaunchManager.h"
+#include "Managers/LookingGlassMemoryManager.h"
 
 #include "Async/Async.h"
 #include "Slate/SceneViewport.h"
@@ -25,6 +27,7 @@
 #include "Engine/GameEngine.h"
 
 #include "Interfaces/IPluginManager.h"
+#include "ShaderCore.h"
 #include "ISequencerObjectChangeListener.h"
 
 #if WITH_EDITOR
@@ -41,6 +44,7 @@ void FLookingGlassRuntimeModule::StartupModule()
 	// Create all managers
 	Managers.Add(LookingGlassLaunchManager = MakeShareable(new FLookingGlassLaunchManager()));
 	Managers.Add(LookingGlassCommandLineManager = MakeShareable(new FLookingGlassCommandLineManager()));
+	Managers.Add(MakeShareable(new FLookingGlassMemoryManager()));
 
 	UGameViewportClient::OnViewportCreated().AddRaw(this, &FLookingGlassRuntimeModule::OnGameViewportCreated);
 
@@ -63,8 +67,19 @@ void FLookingGlassRuntimeModule::StartupModule()
 				CurrentCalibration.ViewCone = TilingValues.ViewCone;
 			}
 
-			// Initialize Bridge here - just to let error popups to appear with no fuss.
-			Bridge.Initialize();
+			// Initialize Bridge here - just to let error popups to appear with no fuss. Calibration could come from the
+			// cache, and change later when Bridge reports something different.
+			Bridge.OnDisplaysChanged.AddLambda([]()
+				{
+					ULookingGlassSceneCaptureComponent2D::UpdateTilingPropertiesForAllComponents();
+				});
+
+			// A slow or missing Bridge service shouldn't delay the boot, so it is initialized on a worker thread. The
+			// default calibration is used for rendering until the player starts on a device.
+			BridgeTask = BridgePipe.Launch(TEXT("LookingGlassBridgeInitialize"), [this]()
+				{
+					Bridge.Initialize();
+				});
 
 			// Capture message about adding/removing a new display
 			TSharedPtr<class GenericApplication> PlatformApplication = FSlateApplication::Get().GetPlatformApplication();
@@ -81,6 +96,14 @@ void FLookingGlassRuntimeModule::StartupModule()
 		});
 
 	FString PluginBaseDir = IPluginManager::Get().FindPlugin(PLUGIN_NAME)->GetBaseDir();
+
+	// Map plugin's shaders. The module is loaded at PostConfigInit, so this happens before global shaders are compiled.
+	const FString ShaderVirtualDir = TEXT("/Plugin/LookingGlass");
+	if (!AllShaderSourceDirectoryMappings().Contains(ShaderVirtualDir))
+	{
+		AddShaderSourceDirectoryMapping(ShaderVirtualDir, FPaths::Combine(PluginBaseDir, TEXT("Shaders")));
+	}
+
 	LookingGlassLoader.LoadDLL(PluginBaseDir);
 }
 
@@ -102,32 +125,62 @@ void FLookingGlassRuntimeModule::ShutdownModule()
 	}
 	Managers.Empty();
 
+	WaitForBridge();
 	Bridge.Shutdown();
 
+	// Stop referencing pooled render targets
+	RenderTargetPool.Reset();
+
 	// Release LookingGlassCore.dll when all manager were destroyed
 	LookingGlassLoader.ReleaseDLL();
 }
 
+FLookingGlassRenderTargetPool& FLookingGlassRuntimeModule::GetRenderTargetPool()
+{
+	if (!RenderTargetPool.IsValid())
+	{
+		RenderTargetPool = MakeUnique<FLookingGlassRenderTargetPool>();
+	}
+	return *RenderTargetPool;
+}
+
 void FLookingGlassRuntimeModule::OnDisplayMetricsChanged(const FDisplayMetrics& InDisplayMetrics)
 {
 	// Ensure the following code will be executed in context of the main thread, and not in the message handler. Without
 	// that, reconfiguring the display when device is connected or disconnected may cause assertions and/or crashes.
 	AsyncTask(ENamedThreads::GameThread, [this, InDisplayMetrics]()
 		{
-			// Reload calibration only if amount of displays has been changed
+			// Reload calibration only if amount of displays has been changed. Components are updated from
+			// Bridge.OnDisplaysChanged once the new displays are published.
 			if (InDisplayMetrics.MonitorInfo.Num() != NumMonitors)
 			{
 				PrepareDisplays();
 			}
 
 			NumMonitors = InDisplayMetrics.MonitorInfo.Num();
-			ULookingGlassSceneCaptureComponent2D::UpdateTilingPropertiesForAllComponents();
 		});
 }
 
 void FLookingGlassRuntimeModule::PrepareDisplays()
 {
-	Bridge.ReadDisplays();
+	// The pipe runs this after Initialize() without holding a worker while waiting for it
+	BridgeTask = BridgePipe.Launch(TEXT("LookingGlassReadDisplays"), [this]()
+		{
+			// Displays are read by Initialize() as well, so nothing to do if it fails
+			if (Bridge.bInitialized)
+			{
+				Bridge.ReadDisplays();
+			}
+		});
+}
+
+void FLookingGlassRuntimeModule::WaitForBridge()
+{
+	if (BridgeTask.IsValid() && !BridgeTask.IsCompleted())
+	{
+		UE_LOG(LookingGlassLogPlayer, Log, TEXT("Waiting for Bridge"));
+		BridgeTask.Wait();
+	}
 }
 
 #if WITH_EDITOR
@@ -164,9 +217,14 @@ void FLookingGlassRuntimeModule::StartPlayer(ELookingGlassModeType LookingGlassM
 		return;
 	}
 
+	// Device data is needed from here on. The game-thread task posted by the worker may not have run yet, so the
+	// calibration is published here.
 	PrepareDisplays();
+	WaitForBridge();
+	Bridge.PublishCalibration();
 
 	bIsRenderingOnDevice = true;
+	bInterleaveInEngine = false;
 
 	const EAutoCenter AutoCenter = EAutoCenter::None;
 	EWindowMode::Type WindowType = EWindowMode::Fullscreen;
@@ -242,6 +300,25 @@ void FLookingGlassRuntimeModule::StartPlayer(ELookingGlassModeType LookingGlassM
 		if (bIsRenderingOnDevice)
 		{
 			CurrentCalibration = Bridge.Displays[ScreenIndex];
+
+			// The window itself covers the panel when the hologram is interleaved by the plugin
+			LookingGlass::FLenticularParams LenticularParams;
+			bool bCanInterleave = LookingGlassSettings->LookingGlassRenderingSettings.bInterleaveInEngine && LenticularParams.Init(CurrentCalibration);
+			if (bCanInterleave && CurrentCalibration.CellPatternMode != 0)
+			{
+				// The shader's layout of repeated subpixel cells hasn't been verified on such panels yet
+				UE_LOG(LookingGlassLogPlayer, Warning, TEXT("Display %s uses subpixel cell pattern %d, which isn't supported by in-engine interleaving, presenting through Bridge"),
+					*CurrentCalibration.Serial, CurrentCalibration.CellPatternMode);
+				bCanInterleave = false;
+			}
+			if (bCanInterleave)
+			{
+				bInterleaveInEngine = true;
+				ClientSize = FVector2D(CurrentCalibration.Width, CurrentCalibration.Height);
+				ScreenPosition = FVector2D(CurrentCalibration.WindowPosition.X, CurrentCalibration.WindowPosition.Y);
+				UE_LOG(LookingGlassLogPlayer, Log, TEXT("Interleaving in engine, window %dx%d at %d,%d"),
+					CurrentCalibration.Width, CurrentCalibration.Height, CurrentCalibration.WindowPosition.X, CurrentCalibration.WindowPosition.Y);
+			}
 		}
 		else
 		{
@@ -270,7 +347,7 @@ void FLookingGlassRuntimeModule::StartPlayer(ELookingGlassModeType LookingGlassM
 			.IsTopmostWindow(WindowSettings.bToptmostDebugWindow);
 
 		// Always make a ViewportClient, because rendering code is located in this class
-		if (bIsRenderingOnDevice)
+		if (bIsRenderingOnDevice && !bInterleaveInEngine)
 		{
 			LookingGlassWindow->HideWindow();
 		}
@@ -4,8 +4,10 @@
 
 #include "HAL/PlatformProcess.h"
 #include "Misc/Paths.h"
+#include "Tasks/Pipe.h"
 
 #include "LookingGlassBridge.h"
+#include "Render/LookingGlassRenderTargetPool.h"
 
 class FViewport;
 
@@ -51,6 +53,12 @@ public:
 		PlatformName = "osx";
 #endif // PLATFORM_WINDOWS
 
+		// There's no DLL to load on other platforms
+		if (LookingGlassDll.IsEmpty())
+		{
+			return false;
+		}
+
 		// Pick the DLL from plugin's binaries directory (copied there from Build.cs using "RuntimeDependencies" function)
 		FString DllPath = FPaths::Combine(PluginBaseDir, TEXT("Binaries"), PlatformName);
 
@@ -154,16 +162,19 @@ public:
 
 	virtual bool IsRenderingOnDevice() const override { return bIsRenderingOnDevice; }
 
+	virtual bool IsInterleavingInEngine() const override { return bIsRenderingOnDevice && bInterleaveInEngine; }
+
 	virtual const FLGDeviceCalibration& GetCurrentCalibration() const override { return CurrentCalibration; }
 
 #if WITH_EDITOR
 	virtual bool HasActiveSequencers() override;
 #endif
 
-	virtual FLookingGlassBridge& GetBridge() override
-	{
-		return Bridge;
-	}
+	virtual FLookingGlassBridge& GetBridge() override { return Bridge; }
+
+	virtual bool IsBridgeReady() const override { return !BridgeTask.IsValid() || BridgeTask.IsCompleted(); }
+
+	virtual FLookingGlassRenderTargetPool& GetRenderTargetPool() override;
 
 private:
 
@@ -206,8 +217,13 @@ private:
 
 	void OnGameViewportCreated();
 
+	// Enumerates displays on a worker thread, after Bridge initialization
 	void PrepareDisplays();
 
+	// Blocks until Bridge initialization and display enumeration are done. Called only when the player starts and on shutdown,
+	// rendering checks IsBridgeReady() instead.
+	void WaitForBridge();
+
 	void InitAllManagers();
 
 	void OnSequencerCreated(TSharedRef<ISequencer> InSequencer);
@@ -219,6 +235,8 @@ private:
 
 	bool bIsRenderingOnDevice = false;
 
+	bool bInterleaveInEngine = false;
+
 	FLGDeviceCalibration CurrentCalibration;
 
 	TSharedPtr<FLookingGlassCommandLineManager> LookingGlassCommandLineManager;
@@ -227,6 +245,15 @@ private:
 
 	FLookingGlassBridge Bridge;
 	FLookingGlassLoader LookingGlassLoader;
+
+	// Runs Bridge tasks one after another: initialization, then display enumerations
+	UE::Tasks::FPipe BridgePipe{ TEXT("LookingGlassBridge") };
+
+	// The last task launched in BridgePipe
+	UE::Tasks::FTask BridgeTask;
+
+	// Created on first use, when UObjects are available
+	TUniquePtr<FLookingGlassRenderTargetPool> RenderTargetPool;
 	FCriticalSection LookingGlassCritialSection;
 
 	TArray<TSharedPtr<ILookingGlassManager>> Managers;
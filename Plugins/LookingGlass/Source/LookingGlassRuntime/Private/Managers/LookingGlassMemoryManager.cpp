@@ -0,0 +1,72 @@
+#include "Managers/LookingGlassMemoryManager.h"
+
+#include "ILookingGlassRuntime.h"
+#include "LookingGlassSettings.h"
+#include "Game/LookingGlassSceneCaptureComponent2D.h"
+#include "Render/LookingGlassRenderTargetPool.h"
+#include "Render/LookingGlassViewportClient.h"
+#include "Render/SLookingGlassViewport.h"
+
+#include "Misc/LookingGlassLog.h"
+
+FLookingGlassMemoryManager::FLookingGlassMemoryManager()
+{
+}
+
+FLookingGlassMemoryManager::~FLookingGlassMemoryManager()
+{
+}
+
+void FLookingGlassMemoryManager::Tick(float DeltaTime)
+{
+	if (!ILookingGlassRuntime::IsAvailable())
+	{
+		return;
+	}
+
+	ILookingGlassRuntime& LookingGlassRuntime = ILookingGlassRuntime::Get();
+
+	// The pool trims itself on every lease and release, with the same time. Pushed every tick, so changing the
+	// setting applies right away, including 0.
+	const float IdleTime = GetDefault<ULookingGlassSettings>()->LookingGlassRenderingSettings.IdleMemoryReleaseTime;
+	LookingGlassRuntime.GetRenderTargetPool().SetIdleTime(IdleTime);
+	if (IdleTime <= 0.0f)
+	{
+		return;
+	}
+
+	const double IdleSince = FPlatformTime::Seconds() - IdleTime;
+
+	for (const TWeakObjectPtr<ULookingGlassSceneCaptureComponent2D>& CaptureComponent : LookingGlassRuntime.GameLookingGlassCaptureComponents)
+	{
+		ReleaseIdleComponent(CaptureComponent.Get(), IdleSince);
+	}
+#if WITH_EDITOR
+	for (const TWeakObjectPtr<ULookingGlassSceneCaptureComponent2D>& CaptureComponent : LookingGlassRuntime.EditorLookingGlassCaptureComponents)
+	{
+		ReleaseIdleComponent(CaptureComponent.Get(), IdleSince);
+	}
+#endif
+
+	// The window could be hidden or minimized, so it isn't drawn anymore
+	TSharedPtr<SLookingGlassViewport> LookingGlassViewport = LookingGlassRuntime.GetLookingGlassViewport();
+	if (LookingGlassViewport.IsValid())
+	{
+		TSharedRef<FLookingGlassViewportClient> ViewportClient = LookingGlassViewport->GetLookingGlassViewportClient();
+		if (ViewportClient->GetLastDrawTime() < IdleSince)
+		{
+			ViewportClient->ReduceMemoryUse();
+		}
+	}
+
+	// Targets returned to the pool above, or by rebuilt configs, are freed when nobody leases them for the same time
+	LookingGlassRuntime.GetRenderTargetPool().Trim(IdleTime);
+}
+
+void FLookingGlassMemoryManager::ReleaseIdleComponent(ULookingGlassSceneCaptureComponent2D* CaptureComponent, double IdleSince)
+{
+	if (CaptureComponent != nullptr && CaptureComponent->GetLastRenderTime() < IdleSince)
+	{
+		CaptureComponent->ReduceMemoryUse();
+	}
+}
@@ -0,0 +1,787 @@
+#include "Misc/LookingGlassImageEncoder.h"
+#include "Misc/LookingGlassLog.h"
+
+#include "Async/ParallelFor.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "HAL/IConsoleManager.h"
+#include "IImageWrapper.h"
+#include "IImageWrapperModule.h"
+#include "Modules/ModuleManager.h"
+
+THIRD_PARTY_INCLUDES_START
+#include "zlib.h"
+THIRD_PARTY_INCLUDES_END
+
+namespace LookingGlass
+{
+namespace ImageEncoder
+{
+	// Strips should be large enough to keep compression ratio, and there should be enough of them to load all workers
+	static constexpr int32 MinRowsPerStrip = 64;
+
+	static int32 GetNumStrips(int32 NumStrips, int32 NumRows)
+	{
+		if (NumStrips <= 0)
+		{
+			NumStrips = (FTaskGraphInterface::Get().GetNumWorkerThreads() + 1) * 2;
+		}
+		return FMath::Clamp(NumStrips, 1, FMath::Max(NumRows / MinRowsPerStrip, 1));
+	}
+
+	static void WriteBigEndian32(TArray64<uint8>& Out, uint32 Value)
+	{
+		Out.Add((uint8)(Value >> 24));
+		Out.Add((uint8)(Value >> 16));
+		Out.Add((uint8)(Value >> 8));
+		Out.Add((uint8)Value);
+	}
+
+	static void WriteBigEndian16(TArray64<uint8>& Out, uint32 Value)
+	{
+		Out.Add((uint8)(Value >> 8));
+		Out.Add((uint8)Value);
+	}
+
+	/*
+	 * PNG
+	 */
+
+	static void WritePNGChunk(TArray64<uint8>& Out, const char* Type, const uint8* Data1, int64 Size1, const uint8* Data2 = nullptr, int64 Size2 = 0)
+	{
+		WriteBigEndian32(Out, (uint32)(Size1 + Size2));
+		const int64 TypeOffset = Out.Num();
+		Out.Append((const uint8*)Type, 4);
+		uLong Crc = crc32(0L, Out.GetData() + TypeOffset, 4);
+		if (Size1 > 0)
+		{
+			Out.Append(Data1, Size1);
+			Crc = crc32(Crc, Data1, (uInt)Size1);
+		}
+		if (Size2 > 0)
+		{
+			Out.Append(Data2, Size2);
+			Crc = crc32(Crc, Data2, (uInt)Size2);
+		}
+		WriteBigEndian32(Out, (uint32)Crc);
+	}
+
+	static uint8 PaethPredictor(int32 A, int32 B, int32 C)
+	{
+		const int32 P = A + B - C;
+		const int32 PA = FMath::Abs(P - A);
+		const int32 PB = FMath::Abs(P - B);
+		const int32 PC = FMath::Abs(P - C);
+		if (PA <= PB && PA <= PC)
+		{
+			return (uint8)A;
+		}
+		return (uint8)(PB <= PC ? B : C);
+	}
+
+	static void ConvertRowToRGB(const FColor* Src, int32 Width, uint8* Dst)
+	{
+		for (int32 X = 0; X < Width; X++)
+		{
+			Dst[X * 3 + 0] = Src[X].R;
+			Dst[X * 3 + 1] = Src[X].G;
+			Dst[X * 3 + 2] = Src[X].B;
+		}
+	}
+
+	// Result of compression of one strip of rows
+	struct FPNGStrip
+	{
+		TArray64<uint8> Compressed;
+		uLong Adler = 1;
+		int64 RawSize = 0;
+		bool bSuccess = false;
+	};
+
+	static void EncodePNGStrip(const FColor* Pixels, int32 Width, int32 StartRow, int32 EndRow, bool bLastStrip, FPNGStrip& Strip)
+	{
+		const int64 RowBytes = (int64)Width * 3;
+
+		// Filter all rows with Paeth predictor. It needs the previous row, which is taken from the image for the first row of the strip.
+		TArray64<uint8> Filtered;
+		Filtered.SetNumUninitialized((RowBytes + 1) * (EndRow - StartRow));
+
+		TArray64<uint8> PrevRow;
+		TArray64<uint8> CurRow;
+		PrevRow.SetNumZeroed(RowBytes);
+		CurRow.SetNumUninitialized(RowBytes);
+		if (StartRow > 0)
+		{
+			ConvertRowToRGB(Pixels + (int64)(StartRow - 1) * Width, Width, PrevRow.GetData());
+		}
+
+		uint8* Dst = Filtered.GetData();
+		for (int32 Y = StartRow; Y < EndRow; Y++)
+		{
+			ConvertRowToRGB(Pixels + (int64)Y * Width, Width, CurRow.GetData());
+			const uint8* Cur = CurRow.GetData();
+			const uint8* Prev = PrevRow.GetData();
+
+			*Dst++ = 4; // Paeth
+			for (int64 Index = 0; Index < RowBytes; Index++)
+			{
+				const int32 Left = Index >= 3 ? Cur[Index - 3] : 0;
+				const int32 UpLeft = Index >= 3 ? Prev[Index - 3] : 0;
+				*Dst++ = (uint8)(Cur[Index] - PaethPredictor(Left, Prev[Index], UpLeft));
+			}
+
+			Swap(PrevRow, CurRow);
+		}
+
+		Strip.RawSize = Filtered.Num();
+		Strip.Adler = adler32(1L, Filtered.GetData(), (uInt)Filtered.Num());
+
+		// Raw deflate stream. Strips which are not last are ended with sync flush: the output is byte aligned and
+		// has no final block, so the next strip's stream could be appended to it.
+		z_stream Stream;
+		FMemory::Memzero(Stream);
+		if (deflateInit2(&Stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+		{
+			return;
+		}
+
+		Strip.Compressed.SetNumUninitialized(deflateBound(&Stream, (uLong)Filtered.Num()) + 16);
+		Stream.next_in = Filtered.GetData();
+		Stream.avail_in = (uInt)Filtered.Num();
+		Stream.next_out = Strip.Compressed.GetData();
+		Stream.avail_out = (uInt)Strip.Compressed.Num();
+
+		const int32 Result = deflate(&Stream, bLastStrip ? Z_FINISH : Z_SYNC_FLUSH);
+		Strip.bSuccess = (bLastStrip ? Result == Z_STREAM_END : Result == Z_OK) && Stream.avail_in == 0;
+		Strip.Compressed.SetNum(Stream.total_out);
+
+		deflateEnd(&Stream);
+	}
+
+	bool EncodePNG(const FColor* Pixels, int32 Width, int32 Height, TArray64<uint8>& OutData, int32 NumStrips)
+	{
+		if (Pixels == nullptr || Width <= 0 || Height <= 0)
+		{
+			return false;
+		}
+
+		NumStrips = GetNumStrips(NumStrips, Height);
+		const int32 RowsPerStrip = FMath::DivideAndRoundUp(Height, NumStrips);
+		NumStrips = FMath::DivideAndRoundUp(Height, RowsPerStrip);
+
+		TArray<FPNGStrip> Strips;
+		Strips.SetNum(NumStrips);
+
+		ParallelFor(NumStrips, [&](int32 StripIndex)
+		{
+			const int32 StartRow = StripIndex * RowsPerStrip;
+			const int32 EndRow = FMath::Min(StartRow + RowsPerStrip, Height);
+			EncodePNGStrip(Pixels, Width, StartRow, EndRow, StripIndex == NumStrips - 1, Strips[StripIndex]);
+		}, NumStrips == 1);
+
+		int64 CompressedSize = 0;
+		uLong Adler = 1;
+		for (int32 StripIndex = 0; StripIndex < NumStrips; StripIndex++)
+		{
+			const FPNGStrip& Strip = Strips[StripIndex];
+			if (!Strip.bSuccess)
+			{
+				return false;
+			}
+			CompressedSize += Strip.Compressed.Num();
+			Adler = StripIndex == 0 ? Strip.Adler : adler32_combine(Adler, Strip.Adler, (z_off_t)Strip.RawSize);
+		}
+
+		OutData.Reset();
+		OutData.Reserve(CompressedSize + NumStrips * 12 + 64);
+
+		static const uint8 Signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+		OutData.Append(Signature, 8);
+
+		TArray64<uint8> Header;
+		WriteBigEndian32(Header, Width);
+		WriteBigEndian32(Header, Height);
+		Header.Add(8);	// bit depth
+		Header.Add(2);	// color type: RGB
+		Header.Add(0);	// compression
+		Header.Add(0);	// filter
+		Header.Add(0);	// interlace
+		WritePNGChunk(OutData, "IHDR", Header.GetData(), Header.Num());
+
+		// One IDAT chunk per strip. Data of all IDAT chunks together is a zlib stream: header, deflate data, Adler-32.
+		static const uint8 ZlibHeader[2] = { 0x78, 0x9C };
+		for (int32 StripIndex = 0; StripIndex < NumStrips; StripIndex++)
+		{
+			const TArray64<uint8>& Compressed = Strips[StripIndex].Compressed;
+			if (StripIndex == 0)
+			{
+				WritePNGChunk(OutData, "IDAT", ZlibHeader, 2, Compressed.GetData(), Compressed.Num());
+			}
+			else
+			{
+				WritePNGChunk(OutData, "IDAT", Compressed.GetData(), Compressed.Num());
+			}
+		}
+		TArray64<uint8> Trailer;
+		WriteBigEndian32(Trailer, (uint32)Adler);
+		WritePNGChunk(OutData, "IDAT", Trailer.GetData(), Trailer.Num());
+
+		WritePNGChunk(OutData, "IEND", nullptr, 0);
+
+		return true;
+	}
+
+	/*
+	 * JPEG
+	 */
+
+	static const uint8 ZigZag[64] =
+	{
+		 0,  1,  8, 16,  9,  2,  3, 10, 17, 24, 32, 25, 18, 11,  4,  5,
+		12, 19, 26, 33, 40, 48, 41, 34, 27, 20, 13,  6,  7, 14, 21, 28,
+		35, 42, 49, 56, 57, 50, 43, 36, 29, 22, 15, 23, 30, 37, 44, 51,
+		58, 59, 52, 45, 38, 31, 39, 46, 53, 60, 61, 54, 47, 55, 62, 63
+	};
+
+	// Standard tables from JPEG specification, Annex K
+	static const uint8 StdLuminanceQuant[64] =
+	{
+		16, 11, 10, 16, 24, 40, 51, 61,		12, 12, 14, 19, 26, 58, 60, 55,
+		14, 13, 16, 24, 40, 57, 69, 56,		14, 17, 22, 29, 51, 87, 80, 62,
+		18, 22, 37, 56, 68, 109, 103, 77,	24, 35, 55, 64, 81, 104, 113, 92,
+		49, 64, 78, 87, 103, 121, 120, 101,	72, 92, 95, 98, 112, 100, 103, 99
+	};
+
+	static const uint8 StdChrominanceQuant[64] =
+	{
+		17, 18, 24, 47, 99, 99, 99, 99,		18, 21, 26, 66, 99, 99, 99, 99,
+		24, 26, 56, 99, 99, 99, 99, 99,		47, 66, 99, 99, 99, 99, 99, 99,
+		99, 99, 99, 99, 99, 99, 99, 99,		99, 99, 99, 99, 99, 99, 99, 99,
+		99, 99, 99, 99, 99, 99, 99, 99,		99, 99, 99, 99, 99, 99, 99, 99
+	};
+
+	static const uint8 StdDCLuminanceBits[16] = { 0, 1, 5, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0 };
+	static const uint8 StdDCLuminanceValues[12] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11 };
+	static const uint8 StdDCChrominanceBits[16] = { 0, 3, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0 };
+	static const uint8 StdDCChrominanceValues[12] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11 };
+
+	static const uint8 StdACLuminanceBits[16] = { 0, 2, 1, 3, 3, 2, 4, 3, 5, 5, 4, 4, 0, 0, 1, 0x7d };
+	static const uint8 StdACLuminanceValues[162] =
+	{
+		0x01, 0x02, 0x03, 0x00, 0x04, 0x11, 0x05, 0x12, 0x21, 0x31, 0x41, 0x06, 0x13, 0x51, 0x61, 0x07,
+		0x22, 0x71, 0x14, 0x32, 0x81, 0x91, 0xa1, 0x08, 0x23, 0x42, 0xb1, 0xc1, 0x15, 0x52, 0xd1, 0xf0,
+		0x24, 0x33, 0x62, 0x72, 0x82, 0x09, 0x0a, 0x16, 0x17, 0x18, 0x19, 0x1a, 0x25, 0x26, 0x27, 0x28,
+		0x29, 0x2a, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3a, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49,
+		0x4a, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5a, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69,
+		0x6a, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7a, 0x83, 0x84, 0x85, 0x86, 0x87, 0x88, 0x89,
+		0x8a, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99, 0x9a, 0xa2, 0xa3, 0xa4, 0xa5, 0xa6, 0xa7,
+		0xa8, 0xa9, 0xaa, 0xb2, 0xb3, 0xb4, 0xb5, 0xb6, 0xb7, 0xb8, 0xb9, 0xba, 0xc2, 0xc3, 0xc4, 0xc5,
+		0xc6, 0xc7, 0xc8, 0xc9, 0xca, 0xd2, 0xd3, 0xd4, 0xd5, 0xd6, 0xd7, 0xd8, 0xd9, 0xda, 0xe1, 0xe2,
+		0xe3, 0xe4, 0xe5, 0xe6, 0xe7, 0xe8, 0xe9, 0xea, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8,
+		0xf9, 0xfa
+	};
+
+	static const uint8 StdACChrominanceBits[16] = { 0, 2, 1, 2, 4, 4, 3, 4, 7, 5, 4, 4, 0, 1, 2, 0x77 };
+	static const uint8 StdACChrominanceValues[162] =
+	{
+		0x00, 0x01, 0x02, 0x03, 0x11, 0x04, 0x05, 0x21, 0x31, 0x06, 0x12, 0x41, 0x51, 0x07, 0x61, 0x71,
+		0x13, 0x22, 0x32, 0x81, 0x08, 0x14, 0x42, 0x91, 0xa1, 0xb1, 0xc1, 0x09, 0x23, 0x33, 0x52, 0xf0,
+		0x15, 0x62, 0x72, 0xd1, 0x0a, 0x16, 0x24, 0x34, 0xe1, 0x25, 0xf1, 0x17, 0x18, 0x19, 0x1a, 0x26,
+		0x27, 0x28, 0x29, 0x2a, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3a, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48,
+		0x49, 0x4a, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5a, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68,
+		0x69, 0x6a, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7a, 0x82, 0x83, 0x84, 0x85, 0x86, 0x87,
+		0x88, 0x89, 0x8a, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99, 0x9a, 0xa2, 0xa3, 0xa4, 0xa5,
+		0xa6, 0xa7, 0xa8, 0xa9, 0xaa, 0xb2, 0xb3, 0xb4, 0xb5, 0xb6, 0xb7, 0xb8, 0xb9, 0xba, 0xc2, 0xc3,
+		0xc4, 0xc5, 0xc6, 0xc7, 0xc8, 0xc9, 0xca, 0xd2, 0xd3, 0xd4, 0xd5, 0xd6, 0xd7, 0xd8, 0xd9, 0xda,
+		0xe2, 0xe3, 0xe4, 0xe5, 0xe6, 0xe7, 0xe8, 0xe9, 0xea, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8,
+		0xf9, 0xfa
+	};
+
+	struct FHuffmanCode
+	{
+		uint16 Code = 0;
+		uint8 Length = 0;
+	};
+
+	struct FHuffmanTable
+	{
+		FHuffmanCode Codes[256];
+
+		FHuffmanTable(const uint8* Bits, const uint8* Values)
+		{
+			uint32 Code = 0;
+			int32 ValueIndex = 0;
+			for (int32 Length = 1; Length <= 16; Length++)
+			{
+				for (int32 Index = 0; Index < Bits[Length - 1]; Index++)
+				{
+					Codes[Values[ValueIndex++]] = { (uint16)Code, (uint8)Length };
+					Code++;
+				}
+				Code <<= 1;
+			}
+		}
+	};
+
+	// Scale factors of AAN DCT, see jfdctflt.c from IJG library
+	static const float AANScaleFactors[8] = { 1.0f, 1.387039845f, 1.306562965f, 1.175875602f, 1.0f, 0.785694958f, 0.541196100f, 0.275899379f };
+
+	// Everything which is shared between strips
+	struct FJPEGTables
+	{
+		uint8 Quant[2][64];
+		// Reciprocal of the quantization divisor for every DCT output, in natural order
+		float Divisors[2][64];
+
+		FHuffmanTable DCLuminance = FHuffmanTable(StdDCLuminanceBits, StdDCLuminanceValues);
+		FHuffmanTable ACLuminance = FHuffmanTable(StdACLuminanceBits, StdACLuminanceValues);
+		FHuffmanTable DCChrominance = FHuffmanTable(StdDCChrominanceBits, StdDCChrominanceValues);
+		FHuffmanTable ACChrominance = FHuffmanTable(StdACChrominanceBits, StdACChrominanceValues);
+
+		explicit FJPEGTables(int32 Quality)
+		{
+			Quality = FMath::Clamp(Quality, 1, 100);
+			const int32 Scale = Quality < 50 ? 5000 / Quality : 200 - Quality * 2;
+			for (int32 Index = 0; Index < 64; Index++)
+			{
+				Quant[0][Index] = (uint8)FMath::Clamp((StdLuminanceQuant[Index] * Scale + 50) / 100, 1, 255);
+				Quant[1][Index] = (uint8)FMath::Clamp((StdChrominanceQuant[Index] * Scale + 50) / 100, 1, 255);
+			}
+			for (int32 Table = 0; Table < 2; Table++)
+			{
+				for (int32 Row = 0; Row < 8; Row++)
+				{
+					for (int32 Col = 0; Col < 8; Col++)
+					{
+						const int32 Index = Row * 8 + Col;
+						Divisors[Table][Index] = 1.0f / (Quant[Table][Index] * AANScaleFactors[Row] * AANScaleFactors[Col] * 8.0f);
+					}
+				}
+			}
+		}
+	};
+
+	// Entropy coded data with byte stuffing
+	struct FJPEGBitWriter
+	{
+		TArray64<uint8>& Out;
+		uint32 Buffer = 0;
+		int32 NumBits = 0;
+
+		explicit FJPEGBitWriter(TArray64<uint8>& InOut)
+			: Out(InOut)
+		{
+		}
+
+		FORCEINLINE void Write(uint32 Code, int32 Length)
+		{
+			Buffer = (Buffer << Length) | (Code & ((1u << Length) - 1));
+			NumBits += Length;
+			while (NumBits >= 8)
+			{
+				const uint8 Byte = (uint8)(Buffer >> (NumBits - 8));
+				Out.Add(Byte);
+				if (Byte == 0xFF)
+				{
+					Out.Add(0);
+				}
+				NumBits -= 8;
+			}
+		}
+
+		// Pad the last byte with ones, which is required before a restart marker and at the end of data
+		void Flush()
+		{
+			if (NumBits > 0)
+			{
+				Write(0x7F, 8 - NumBits);
+			}
+			Buffer = 0;
+		}
+	};
+
+	static void ForwardDCT1D(float* Data, int32 Stride)
+	{
+		float& D0 = Data[0];
+		float& D1 = Data[Stride];
+		float& D2 = Data[Stride * 2];
+		float& D3 = Data[Stride * 3];
+		float& D4 = Data[Stride * 4];
+		float& D5 = Data[Stride * 5];
+		float& D6 = Data[Stride * 6];
+		float& D7 = Data[Stride * 7];
+
+		const float Tmp0 = D0 + D7;
+		const float Tmp7 = D0 - D7;
+		const float Tmp1 = D1 + D6;
+		const float Tmp6 = D1 - D6;
+		const float Tmp2 = D2 + D5;
+		const float Tmp5 = D2 - D5;
+		const float Tmp3 = D3 + D4;
+		const float Tmp4 = D3 - D4;
+
+		// Even part
+		float Tmp10 = Tmp0 + Tmp3;
+		const float Tmp13 = Tmp0 - Tmp3;
+		float Tmp11 = Tmp1 + Tmp2;
+		float Tmp12 = Tmp1 - Tmp2;
+
+		D0 = Tmp10 + Tmp11;
+		D4 = Tmp10 - Tmp11;
+
+		const float Z1 = (Tmp12 + Tmp13) * 0.707106781f;
+		D2 = Tmp13 + Z1;
+		D6 = Tmp13 - Z1;
+
+		// Odd part
+		Tmp10 = Tmp4 + Tmp5;
+		Tmp11 = Tmp5 + Tmp6;
+		Tmp12 = Tmp6 + Tmp7;
+
+		const float Z5 = (Tmp10 - Tmp12) * 0.382683433f;
+		const float Z2 = 0.541196100f * Tmp10 + Z5;
+		const float Z4 = 1.306562965f * Tmp12 + Z5;
+		const float Z3 = Tmp11 * 0.707106781f;
+
+		const float Z11 = Tmp7 + Z3;
+		const float Z13 = Tmp7 - Z3;
+
+		D5 = Z13 + Z2;
+		D3 = Z13 - Z2;
+		D1 = Z11 + Z4;
+		D7 = Z11 - Z4;
+	}
+
+	static void EncodeJPEGBlock(FJPEGBitWriter& Writer, float* Block, const float* Divisors, const FHuffmanTable& DC, const FHuffmanTable& AC, int32& PrevDC)
+	{
+		for (int32 Row = 0; Row < 8; Row++)
+		{
+			ForwardDCT1D(Block + Row * 8, 1);
+		}
+		for (int32 Col = 0; Col < 8; Col++)
+		{
+			ForwardDCT1D(Block + Col, 8);
+		}
+
+		int32 Quantized[64];
+		for (int32 Index = 0; Index < 64; Index++)
+		{
+			const int32 Natural = ZigZag[Index];
+			Quantized[Index] = FMath::RoundToInt(Block[Natural] * Divisors[Natural]);
+		}
+
+		auto WriteValue = [&Writer](const FHuffmanCode& Code, int32 Value, int32 Category)
+		{
+			Writer.Write(Code.Code, Code.Length);
+			if (Category > 0)
+			{
+				// Negative values are written as one's complement
+				Writer.Write(Value < 0 ? Value - 1 : Value, Category);
+			}
+		};
+
+		auto GetCategory = [](int32 Value)
+		{
+			uint32 Magnitude = (uint32)FMath::Abs(Value);
+			int32 Category = 0;
+			while (Magnitude)
+			{
+				Category++;
+				Magnitude >>= 1;
+			}
+			return Category;
+		};
+
+		// DC is coded as difference with the previous block of the same component
+		const int32 Diff = Quantized[0] - PrevDC;
+		PrevDC = Quantized[0];
+		const int32 DCCategory = GetCategory(Diff);
+		WriteValue(DC.Codes[DCCategory], Diff, DCCategory);
+
+		// AC: run length of zeros and value category
+		int32 ZeroRun = 0;
+		for (int32 Index = 1; Index < 64; Index++)
+		{
+			const int32 Value = Quantized[Index];
+			if (Value == 0)
+			{
+				ZeroRun++;
+				continue;
+			}
+			while (ZeroRun > 15)
+			{
+				// ZRL: 16 zeros
+				Writer.Write(AC.Codes[0xF0].Code, AC.Codes[0xF0].Length);
+				ZeroRun -= 16;
+			}
+			const int32 Category = GetCategory(Value);
+			WriteValue(AC.Codes[(ZeroRun << 4) | Category], Value, Category);
+			ZeroRun = 0;
+		}
+		if (ZeroRun > 0)
+		{
+			// EOB
+			Writer.Write(AC.Codes[0x00].Code, AC.Codes[0x00].Length);
+		}
+	}
+
+	static void EncodeJPEGStrip(const FColor* Pixels, int32 Width, int32 Height, int32 StartMCURow, int32 EndMCURow, const FJPEGTables& Tables, TArray64<uint8>& Out)
+	{
+		const int32 NumMCURows = FMath::DivideAndRoundUp(Height, 8);
+		const int32 NumMCUColumns = FMath::DivideAndRoundUp(Width, 8);
+
+		Out.Reserve((int64)Width * (EndMCURow - StartMCURow) * 8);
+		FJPEGBitWriter Writer(Out);
+
+		float BlockY[64];
+		float BlockCb[64];
+		float BlockCr[64];
+
+		for (int32 MCURow = StartMCURow; MCURow < EndMCURow; MCURow++)
+		{
+			// Every MCU row is a restart interval, so DC predictions start from zero
+			int32 PrevDC[3] = { 0, 0, 0 };
+
+			for (int32 MCUColumn = 0; MCUColumn < NumMCUColumns; MCUColumn++)
+			{
+				// Convert to YCbCr, repeating edge pixels for partial blocks
+				for (int32 Y = 0; Y < 8; Y++)
+				{
+					const int32 PixelY = FMath::Min(MCURow * 8 + Y, Height - 1);
+					const FColor* Row = Pixels + (int64)PixelY * Width;
+					for (int32 X = 0; X < 8; X++)
+					{
+						const FColor& Color = Row[FMath::Min(MCUColumn * 8 + X, Width - 1)];
+						const float R = Color.R;
+						const float G = Color.G;
+						const float B = Color.B;
+						BlockY[Y * 8 + X] = 0.299f * R + 0.587f * G + 0.114f * B - 128.0f;
+						BlockCb[Y * 8 + X] = -0.168736f * R - 0.331264f * G + 0.5f * B;
+						BlockCr[Y * 8 + X] = 0.5f * R - 0.418688f * G - 0.081312f * B;
+					}
+				}
+
+				EncodeJPEGBlock(Writer, BlockY, Tables.Divisors[0], Tables.DCLuminance, Tables.ACLuminance, PrevDC[0]);
+				EncodeJPEGBlock(Writer, BlockCb, Tables.Divisors[1], Tables.DCChrominance, Tables.ACChrominance, PrevDC[1]);
+				EncodeJPEGBlock(Writer, BlockCr, Tables.Divisors[1], Tables.DCChrominance, Tables.ACChrominance, PrevDC[2]);
+			}
+
+			Writer.Flush();
+			if (MCURow < NumMCURows - 1)
+			{
+				// RSTn marker, numbered by the global MCU row
+				Out.Add(0xFF);
+				Out.Add((uint8)(0xD0 + (MCURow & 7)));
+			}
+		}
+	}
+
+	static void WriteHuffmanTable(TArray64<uint8>& Out, uint8 ClassAndId, const uint8* Bits, const uint8* Values, int32 NumValues)
+	{
+		Out.Add(ClassAndId);
+		Out.Append(Bits, 16);
+		Out.Append(Values, NumValues);
+	}
+
+	bool EncodeJPEG(const FColor* Pixels, int32 Width, int32 Height, int32 Quality, TArray64<uint8>& OutData, int32 NumStrips)
+	{
+		if (Pixels == nullptr || Width <= 0 || Height <= 0 || Width > 65535 || Height > 65535)
+		{
+			return false;
+		}
+
+		const FJPEGTables Tables(Quality);
+
+		const int32 NumMCURows = FMath::DivideAndRoundUp(Height, 8);
+		const int32 NumMCUColumns = FMath::DivideAndRoundUp(Width, 8);
+		if (NumMCUColumns > 65535)
+		{
+			return false;
+		}
+
+		NumStrips = GetNumStrips(NumStrips, Height);
+		const int32 MCURowsPerStrip = FMath::DivideAndRoundUp(NumMCURows, NumStrips);
+		NumStrips = FMath::DivideAndRoundUp(NumMCURows, MCURowsPerStrip);
+
+		TArray<TArray64<uint8>> Strips;
+		Strips.SetNum(NumStrips);
+
+		ParallelFor(NumStrips, [&](int32 StripIndex)
+		{
+			const int32 StartMCURow = StripIndex * MCURowsPerStrip;
+			const int32 EndMCURow = FMath::Min(StartMCURow + MCURowsPerStrip, NumMCURows);
+			EncodeJPEGStrip(Pixels, Width, Height, StartMCURow, EndMCURow, Tables, Strips[StripIndex]);
+		}, NumStrips == 1);
+
+		int64 CompressedSize = 0;
+		for (const TArray64<uint8>& Strip : Strips)
+		{
+			CompressedSize += Strip.Num();
+		}
+
+		OutData.Reset();
+		OutData.Reserve(CompressedSize + 1024);
+
+		// SOI, APP0 (JFIF)
+		static const uint8 Header[] =
+		{
+			0xFF, 0xD8,
+			0xFF, 0xE0, 0x00, 0x10, 'J', 'F', 'I', 'F', 0x00, 0x01, 0x01, 0x00, 0x00, 0x01, 0x00, 0x01, 0x00, 0x00
+		};
+		OutData.Append(Header, sizeof(Header));
+
+		// DQT, both tables in zigzag order
+		OutData.Add(0xFF);
+		OutData.Add(0xDB);
+		WriteBigEndian16(OutData, 2 + 2 * 65);
+		for (int32 Table = 0; Table < 2; Table++)
+		{
+			OutData.Add((uint8)Table);
+			for (int32 Index = 0; Index < 64; Index++)
+			{
+				OutData.Add(Tables.Quant[Table][ZigZag[Index]]);
+			}
+		}
+
+		// SOF0: baseline, 3 components without subsampling
+		static const uint8 Components[] = { 1, 0x11, 0, 2, 0x11, 1, 3, 0x11, 1 };
+		OutData.Add(0xFF);
+		OutData.Add(0xC0);
+		WriteBigEndian16(OutData, 8 + 3 * 3);
+		OutData.Add(8);
+		WriteBigEndian16(OutData, Height);
+		WriteBigEndian16(OutData, Width);
+		OutData.Add(3);
+		OutData.Append(Components, sizeof(Components));
+
+		// DHT
+		OutData.Add(0xFF);
+		OutData.Add(0xC4);
+		WriteBigEndian16(OutData, 2 + (17 + 12) * 2 + (17 + 162) * 2);
+		WriteHuffmanTable(OutData, 0x00, StdDCLuminanceBits, StdDCLuminanceValues, 12);
+		WriteHuffmanTable(OutData, 0x10, StdACLuminanceBits, StdACLuminanceValues, 162);
+		WriteHuffmanTable(OutData, 0x01, StdDCChrominanceBits, StdDCChrominanceValues, 12);
+		WriteHuffmanTable(OutData, 0x11, StdACChrominanceBits, StdACChrominanceValues, 162);
+
+		// DRI: restart interval is one MCU row
+		OutData.Add(0xFF);
+		OutData.Add(0xDD);
+		WriteBigEndian16(OutData, 4);
+		WriteBigEndian16(OutData, NumMCUColumns);
+
+		// SOS
+		static const uint8 Scan[] = { 0xFF, 0xDA, 0x00, 0x0C, 3, 1, 0x00, 2, 0x11, 3, 0x11, 0, 63, 0 };
+		OutData.Append(Scan, sizeof(Scan));
+
+		for (const TArray64<uint8>& Strip : Strips)
+		{
+			OutData.Append(Strip.GetData(), Strip.Num());
+		}
+
+		// EOI
+		OutData.Add(0xFF);
+		OutData.Add(0xD9);
+
+		return true;
+	}
+
+	/*
+	 * Benchmark
+	 */
+
+	// Synthetic quilt: views with gradients and shapes, shifted per view like a real quilt, plus some noise
+	static void MakeBenchmarkQuilt(int32 Width, int32 Height, TArray64<FColor>& OutPixels)
+	{
+		const int32 TilesX = 8;
+		const int32 TilesY = 6;
+		const int32 TileW = Width / TilesX;
+		const int32 TileH = Height / TilesY;
+		OutPixels.SetNumUninitialized((int64)Width * Height);
+
+		ParallelFor(Height, [&](int32 Y)
+		{
+			FRandomStream Random(Y);
+			const int32 TileY = FMath::Min(Y / FMath::Max(TileH, 1), TilesY - 1);
+			const int32 LocalY = Y - TileY * TileH;
+			for (int32 X = 0; X < Width; X++)
+			{
+				const int32 TileX = FMath::Min(X / FMath::Max(TileW, 1), TilesX - 1);
+				const int32 View = TileY * TilesX + TileX;
+				const int32 LocalX = X - TileX * TileW + View * 4;
+
+				const int32 Dx = LocalX - TileW / 2;
+				const int32 Dy = LocalY - TileH / 2;
+				const bool bInCircle = Dx * Dx + Dy * Dy < (TileH / 4) * (TileH / 4);
+				const uint8 Noise = (uint8)Random.RandRange(0, 7);
+
+				FColor& Color = OutPixels[(int64)Y * Width + X];
+				Color.R = (uint8)((LocalX * 255 / FMath::Max(TileW, 1)) & 0xFF) ^ Noise;
+				Color.G = (uint8)(bInCircle ? 220 : (LocalY * 255 / FMath::Max(TileH, 1))) ^ Noise;
+				Color.B = (uint8)((View * 5) & 0xFF);
+				Color.A = 255;
+			}
+		});
+	}
+
+	static void RunBenchmark(const TArray<FString>& Args)
+	{
+		TArray<FIntPoint> Sizes;
+		if (Args.Num() >= 2)
+		{
+			Sizes.Add(FIntPoint(FCString::Atoi(*Args[0]), FCString::Atoi(*Args[1])));
+		}
+		else
+		{
+			Sizes.Add(FIntPoint(4096, 4096));
+			Sizes.Add(FIntPoint(8192, 8192));
+		}
+		const int32 Quality = 85;
+
+		IImageWrapperModule& ImageWrapperModule = FModuleManager::LoadModuleChecked<IImageWrapperModule>(TEXT("ImageWrapper"));
+
+		for (const FIntPoint& Size : Sizes)
+		{
+			if (Size.X <= 0 || Size.Y <= 0)
+			{
+				continue;
+			}
+
+			TArray64<FColor> Pixels;
+			MakeBenchmarkQuilt(Size.X, Size.Y, Pixels);
+
+			auto Measure = [&Size](const TCHAR* Name, TFunctionRef<int64()> Encode)
+			{
+				const double StartTime = FPlatformTime::Seconds();
+				const int64 NumBytes = Encode();
+				const double Time = FPlatformTime::Seconds() - StartTime;
+				UE_LOG(LookingGlassLogGame, Display, TEXT("  %-24s %dx%d: %8.1f ms, %8.2f MB"), Name, Size.X, Size.Y, Time * 1000.0, NumBytes / (1024.0 * 1024.0));
+			};
+
+			auto EncodeWithImageWrapper = [&](EImageFormat Format, int32 CompressionQuality) -> int64
+			{
+				TSharedPtr<IImageWrapper> ImageWrapper = ImageWrapperModule.CreateImageWrapper(Format);
+				if (!ImageWrapper.IsValid() || !ImageWrapper->SetRaw(Pixels.GetData(), Pixels.Num() * sizeof(FColor), Size.X, Size.Y, ERGBFormat::BGRA, 8))
+				{
+					return -1;
+				}
+				return ImageWrapper->GetCompressed(CompressionQuality).Num();
+			};
+
+			UE_LOG(LookingGlassLogGame, Display, TEXT("LookingGlass image encoder benchmark, %d worker threads:"), FTaskGraphInterface::Get().GetNumWorkerThreads());
+
+			TArray64<uint8> Data;
+			Measure(TEXT("PNG, ImageWrapper"), [&]() { return EncodeWithImageWrapper(EImageFormat::PNG, 0); });
+			Measure(TEXT("PNG, single strip"), [&]() { return EncodePNG(Pixels.GetData(), Size.X, Size.Y, Data, 1) ? Data.Num() : -1; });
+			Measure(TEXT("PNG, parallel"), [&]() { return EncodePNG(Pixels.GetData(), Size.X, Size.Y, Data) ? Data.Num() : -1; });
+			Measure(TEXT("JPEG, ImageWrapper"), [&]() { return EncodeWithImageWrapper(EImageFormat::JPEG, Quality); });
+			Measure(TEXT("JPEG, single strip"), [&]() { return EncodeJPEG(Pixels.GetData(), Size.X, Size.Y, Quality, Data, 1) ? Data.Num() : -1; });
+			Measure(TEXT("JPEG, parallel"), [&]() { return EncodeJPEG(Pixels.GetData(), Size.X, Size.Y, Quality, Data) ? Data.Num() : -1; });
+		}
+	}
+
+	// Works without a LookingGlass window or GPU, e.g. "UnrealEditor-Cmd <Project> -nullrhi -ExecCmds="LookingGlass.BenchmarkImageEncoder,Quit""
+	static FAutoConsoleCommand BenchmarkImageEncoderCommand(
+		TEXT("LookingGlass.BenchmarkImageEncoder"),
+		TEXT("Compare parallel PNG/JPEG quilt encoder with ImageWrapper on synthetic quilts. Optional arguments: Width Height."),
+		FConsoleCommandWithArgsDelegate::CreateStatic(&RunBenchmark));
+}
+}
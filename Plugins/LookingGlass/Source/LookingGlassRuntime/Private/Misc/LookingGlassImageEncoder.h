@@ -0,0 +1,52 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Parallel PNG and JPEG encoders for large quilt images. The image is split into horizontal strips which are
+ * compressed independently on task graph workers, and then joined into a single standard file:
+ * - PNG: every strip is a separate raw deflate stream ended with a sync flush, so the streams could be concatenated
+ *   into one zlib stream; Adler-32 checksums of strips are combined.
+ * - JPEG: baseline encoding with a restart marker after every MCU row, so strips don't depend on each other.
+ *
+ * Pixels are BGRA (FColor), alpha is ignored: both formats are written as 8-bit RGB.
+ */
+
+namespace LookingGlass
+{
+	namespace ImageEncoder
+	{
+		/**
+		 * @fn	bool EncodePNG(const FColor* Pixels, int32 Width, int32 Height, TArray64<uint8>& OutData, int32 NumStrips = 0);
+		 *
+		 * @brief	Encodes the image to PNG
+		 *
+		 * @param 		  	Pixels   	Image data, Width * Height pixels.
+		 * @param 		  	Width	 	Image width.
+		 * @param 		  	Height   	Image height.
+		 * @param [in,out]	OutData  	Compressed file data.
+		 * @param 		  	NumStrips	Number of parallel strips, 0 to select automatically. 1 encodes on the calling thread.
+		 *
+		 * @returns	True if it succeeds, false if it fails.
+		 */
+
+		bool EncodePNG(const FColor* Pixels, int32 Width, int32 Height, TArray64<uint8>& OutData, int32 NumStrips = 0);
+
+		/**
+		 * @fn	bool EncodeJPEG(const FColor* Pixels, int32 Width, int32 Height, int32 Quality, TArray64<uint8>& OutData, int32 NumStrips = 0);
+		 *
+		 * @brief	Encodes the image to baseline JPEG, without chroma subsampling
+		 *
+		 * @param 		  	Pixels   	Image data, Width * Height pixels.
+		 * @param 		  	Width	 	Image width, up to 65535.
+		 * @param 		  	Height   	Image height, up to 65535.
+		 * @param 		  	Quality  	Quality, 1..100.
+		 * @param [in,out]	OutData  	Compressed file data.
+		 * @param 		  	NumStrips	Number of parallel strips, 0 to select automatically. 1 encodes on the calling thread.
+		 *
+		 * @returns	True if it succeeds, false if it fails.
+		 */
+
+		bool EncodeJPEG(const FColor* Pixels, int32 Width, int32 Height, int32 Quality, TArray64<uint8>& OutData, int32 NumStrips = 0);
+	}
+}
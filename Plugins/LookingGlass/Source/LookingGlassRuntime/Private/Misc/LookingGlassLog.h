@@ -27,7 +27,7 @@ DECLARE_LOG_CATEGORY_EXTERN(LookingGlassLogSettings, Log, All);
 #if PLATFORM_WINDOWS
 #define DISPLAY_HOLOPLAY_FUNC_TRACE(cat)  UE_LOG(cat, VeryVerbose, TEXT(">> %s"), ANSI_TO_TCHAR(__FUNCTION__))
 #else
-#define DISPLAY_CLUSTER_FUNC_TRACE(cat) ;
+#define DISPLAY_HOLOPLAY_FUNC_TRACE(cat) ;
 #endif // PLATFORM_WINDOWS
 #endif // UE_BUILD_SHIPPING
 
@@ -4,9 +4,42 @@
 
 DECLARE_STATS_GROUP(TEXT("LookingGlass_RenderThread"), STATGROUP_LookingGlass_RenderThread, STATCAT_Advanced);
 DECLARE_CYCLE_STAT(TEXT("CopyToQuiltShader"), STAT_CopyToQuiltShader_RenderThread, STATGROUP_LookingGlass_RenderThread);
+DECLARE_CYCLE_STAT(TEXT("CopyToQuiltBatched"), STAT_CopyToQuiltBatched_RenderThread, STATGROUP_LookingGlass_RenderThread);
+DECLARE_CYCLE_STAT(TEXT("FrameGraph"), STAT_FrameGraph_RenderThread, STATGROUP_LookingGlass_RenderThread);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Quilt copy passes"), STAT_QuiltCopyPasses, STATGROUP_LookingGlass_RenderThread);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Quilt copy draws"), STAT_QuiltCopyDraws, STATGROUP_LookingGlass_RenderThread);
+DECLARE_CYCLE_STAT(TEXT("QuiltReadbackCopy"), STAT_QuiltReadbackCopy_RenderThread, STATGROUP_LookingGlass_RenderThread);
 
 
 DECLARE_STATS_GROUP(TEXT("LookingGlass_GameThread"), STATGROUP_LookingGlass_GameThread, STATCAT_Advanced);
 DECLARE_CYCLE_STAT(TEXT("Draw"), STAT_Draw_GameThread, STATGROUP_LookingGlass_GameThread);
 DECLARE_CYCLE_STAT(TEXT("CaptureScene"), STAT_CaptureScene_GameThread, STATGROUP_LookingGlass_GameThread);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Capture view families"), STAT_CaptureViewFamilies, STATGROUP_LookingGlass_GameThread);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Capture views"), STAT_CaptureViews, STATGROUP_LookingGlass_GameThread);
+DECLARE_DWORD_COUNTER_STAT(TEXT("View batch size"), STAT_ViewBatchSize, STATGROUP_LookingGlass_GameThread);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("View batch memory estimate (MB)"), STAT_ViewBatchMemory, STATGROUP_LookingGlass_GameThread);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Synthesized views"), STAT_SynthesizedViews, STATGROUP_LookingGlass_GameThread);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("View resolution strength"), STAT_ViewResolutionStrength, STATGROUP_LookingGlass_GameThread);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Tiling quality level"), STAT_TilingQualityLevel, STATGROUP_LookingGlass_GameThread);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Render targets leased"), STAT_RenderTargetsLeased, STATGROUP_LookingGlass_GameThread);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Render targets idle"), STAT_RenderTargetsIdle, STATGROUP_LookingGlass_GameThread);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Render target pool memory (MB)"), STAT_RenderTargetPoolMemory, STATGROUP_LookingGlass_GameThread);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Quilt ring memory (MB)"), STAT_QuiltRingMemory, STATGROUP_LookingGlass_GameThread);
 DECLARE_CYCLE_STAT(TEXT("DrawDebugParameters"), STAT_DrawDebugParameters_GameThread, STATGROUP_LookingGlass_GameThread);
+DECLARE_CYCLE_STAT(TEXT("Wait for quilt frame"), STAT_WaitForQuiltFrame_GameThread, STATGROUP_LookingGlass_GameThread);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Quilt present interval (ms)"), STAT_QuiltPresentInterval, STATGROUP_LookingGlass_GameThread);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Quilt frame latency (ms)"), STAT_QuiltFrameLatency, STATGROUP_LookingGlass_GameThread);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Quilt frame wait (ms)"), STAT_QuiltFrameWait, STATGROUP_LookingGlass_GameThread);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Quilt frames in flight"), STAT_QuiltFramesInFlight, STATGROUP_LookingGlass_GameThread);
+DECLARE_CYCLE_STAT(TEXT("Wait for readback"), STAT_WaitForReadback_GameThread, STATGROUP_LookingGlass_GameThread);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Quilt readbacks in flight"), STAT_QuiltReadbacksInFlight, STATGROUP_LookingGlass_GameThread);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Pixel buffers in use"), STAT_PixelBuffersInUse, STATGROUP_LookingGlass_GameThread);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Pixel buffer memory (MB)"), STAT_PixelBufferMemory, STATGROUP_LookingGlass_GameThread);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Capture queue depth"), STAT_CaptureQueueDepth, STATGROUP_LookingGlass_GameThread);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Capture encode throughput (fps)"), STAT_CaptureEncodeThroughput, STATGROUP_LookingGlass_GameThread);
+DECLARE_CYCLE_STAT(TEXT("Capture stall"), STAT_CaptureStall_GameThread, STATGROUP_LookingGlass_GameThread);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Capture stall (ms)"), STAT_CaptureStallTime, STATGROUP_LookingGlass_GameThread);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Capture dropped frames"), STAT_CaptureDroppedFrames, STATGROUP_LookingGlass_GameThread);
+DECLARE_CYCLE_STAT(TEXT("Encode screenshot"), STAT_EncodeScreenshot, STATGROUP_LookingGlass_GameThread);
+DECLARE_CYCLE_STAT(TEXT("Write screenshot"), STAT_WriteScreenshot, STATGROUP_LookingGlass_GameThread);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Screenshot saves in flight"), STAT_ScreenshotSavesInFlight, STATGROUP_LookingGlass_GameThread);
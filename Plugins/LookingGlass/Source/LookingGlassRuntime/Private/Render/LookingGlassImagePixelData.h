@@ -0,0 +1,31 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ImagePixelData.h"
+
+#include "Render/LookingGlassPixelBuffer.h"
+
+/**
+ * @struct	FLookingGlassImagePixelData
+ *
+ * @brief	Image data for FImageWriteTask which references a pixel buffer instead of holding its own copy
+ */
+
+struct FLookingGlassImagePixelData : public FImagePixelData
+{
+	explicit FLookingGlassImagePixelData(const FLookingGlassPixelBufferRef& InBuffer, FImagePixelPayloadPtr InPayload = nullptr);
+
+	virtual TUniquePtr<FImagePixelData> Move() override;
+
+	virtual TUniquePtr<FImagePixelData> Copy() const override;
+
+private:
+	virtual void RetrieveData(const void*& OutDataPtr, int64& OutSizeBytes) const override;
+
+	virtual void RetrieveData(void*& OutDataPtr, int64& OutSizeBytes) override;
+
+	FLookingGlassPixelBufferRef Buffer;
+
+	// Kept to be passed to the moved object
+	FImagePixelPayloadPtr SharedPayload;
+};
@@ -0,0 +1,325 @@
+#include "Render/LookingGlassInterleaver.h"
+#include "Game/LookingGlassSceneCaptureComponent2D.h"
+#include "Misc/LookingGlassImageEncoder.h"
+#include "Misc/LookingGlassLog.h"
+#include "ILookingGlassRuntime.h"
+#include "LookingGlassBridge.h"
+
+#include "Async/ParallelFor.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "HAL/IConsoleManager.h"
+#include "IImageWrapper.h"
+#include "IImageWrapperModule.h"
+#include "Math/VectorRegister.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Modules/ModuleManager.h"
+
+namespace LookingGlass
+{
+	// Byte offset of the color channel of every subpixel, in panel order
+	static const int32 SubpixelChannels[3] = { STRUCT_OFFSET(FColor, R), STRUCT_OFFSET(FColor, G), STRUCT_OFFSET(FColor, B) };
+
+	bool FLenticularParams::Init(const FLGDeviceCalibration& Calibration)
+	{
+		if (Calibration.Width <= 0 || Calibration.Height <= 0 || Calibration.DPI <= 0.0f || Calibration.Pitch <= 0.0f || Calibration.Slope == 0.0f)
+		{
+			return false;
+		}
+
+		ScreenSize = FIntPoint(Calibration.Width, Calibration.Height);
+
+		// Calibration pitch is lenses per inch along the screen width, lenses are slanted by Slope pixels per pixel
+		const float ScreenInches = Calibration.Width / Calibration.DPI;
+		const float Pitch = Calibration.Pitch * ScreenInches * FMath::Cos(FMath::Atan(1.0f / Calibration.Slope));
+		const float Tilt = Calibration.Height / (Calibration.Width * Calibration.Slope);
+		const float Subp = 1.0f / (3.0f * Calibration.Width);
+
+		// Flipped panels are scanned from the right edge, with reversed subpixel order
+		const float Direction = Calibration.FlipX >= 0.5f ? -1.0f : 1.0f;
+		PhaseU = Direction * Pitch;
+		PhaseV = Tilt * Pitch;
+		PhaseSubpixel = Direction * Subp * Pitch;
+		PhaseBias = (Direction < 0.0f ? Pitch : 0.0f) - Calibration.Center;
+		bInvertViews = Calibration.InvView != 0;
+		return true;
+	}
+
+	void InterleaveQuilt(const FLenticularParams& Params, const FColor* Quilt, const FLookingGlassTilingQuality& TilingValues, ELookingGlassQuiltOrder QuiltOrder,
+		TArray<FColor>& OutImage, bool bVectorized, bool bParallel)
+	{
+		const int32 Width = Params.ScreenSize.X;
+		const int32 Height = Params.ScreenSize.Y;
+		const int32 NumViews = TilingValues.GetNumTiles();
+		OutImage.SetNumUninitialized(Width * Height);
+		if (Width <= 0 || Height <= 0 || NumViews <= 0)
+		{
+			return;
+		}
+
+		TArray<FIntRect> TileRects;
+		TileRects.SetNum(NumViews);
+		for (int32 ViewIndex = 0; ViewIndex < NumViews; ++ViewIndex)
+		{
+			FLookingGlassRenderingConfig::CalculateQuiltTileRect(TileRects[ViewIndex], TilingValues, QuiltOrder, ViewIndex);
+		}
+
+		// Texel column inside a tile is the same for all views and rows
+		const float InvWidth = 1.0f / Width;
+		TArray<int32> TexelColumns;
+		TexelColumns.SetNumUninitialized(Width);
+		for (int32 X = 0; X < Width; ++X)
+		{
+			TexelColumns[X] = FMath::Min((int32)((X + 0.5f) * InvWidth * TilingValues.TileSizeX), TilingValues.TileSizeX - 1);
+		}
+
+		auto InterleaveRow = [&](int32 Y)
+		{
+			// Texel row of every view
+			const int32 TexelRow = FMath::Min((int32)((Y + 0.5f) / Height * TilingValues.TileSizeY), TilingValues.TileSizeY - 1);
+			TArray<const FColor*, TInlineAllocator<128>> ViewRows;
+			ViewRows.SetNumUninitialized(NumViews);
+			for (int32 ViewIndex = 0; ViewIndex < NumViews; ++ViewIndex)
+			{
+				const FIntRect& Rect = TileRects[ViewIndex];
+				ViewRows[ViewIndex] = Quilt + (int64)(Rect.Min.Y + TexelRow) * TilingValues.QuiltW + Rect.Min.X;
+			}
+
+			// Image rows go from the top, while the lens phase is defined from the bottom
+			const float V = 1.0f - (Y + 0.5f) / Height;
+			float RowPhases[3];
+			for (int32 Subpixel = 0; Subpixel < 3; ++Subpixel)
+			{
+				RowPhases[Subpixel] = V * Params.PhaseV + Params.PhaseBias + Subpixel * Params.PhaseSubpixel;
+			}
+
+			FColor* Out = OutImage.GetData() + (int64)Y * Width;
+			int32 X = 0;
+
+			if (bVectorized)
+			{
+				// View indices of 4 pixels are computed at once, texels are fetched one by one
+				const VectorRegister PixelOffsets = MakeVectorRegister(0.5f, 1.5f, 2.5f, 3.5f);
+				const VectorRegister VecInvWidth = VectorSetFloat1(InvWidth);
+				const VectorRegister VecPhaseU = VectorSetFloat1(Params.PhaseU);
+				const VectorRegister VecNumViews = VectorSetFloat1((float)NumViews);
+				const VectorRegister VecMaxView = VectorSetFloat1((float)(NumViews - 1));
+				const VectorRegister VecRowPhases[3] = { VectorSetFloat1(RowPhases[0]), VectorSetFloat1(RowPhases[1]), VectorSetFloat1(RowPhases[2]) };
+				alignas(16) float Views[4];
+
+				for (; X + 4 <= Width; X += 4)
+				{
+					const VectorRegister U = VectorMultiply(VectorAdd(VectorSetFloat1((float)X), PixelOffsets), VecInvWidth);
+					for (int32 Subpixel = 0; Subpixel < 3; ++Subpixel)
+					{
+						const VectorRegister Phase = VectorMultiplyAdd(U, VecPhaseU, VecRowPhases[Subpixel]);
+						const VectorRegister Fraction = VectorSubtract(Phase, VectorFloor(Phase));
+						VectorRegister View = VectorMin(VectorFloor(VectorMultiply(Fraction, VecNumViews)), VecMaxView);
+						if (Params.bInvertViews)
+						{
+							View = VectorSubtract(VecMaxView, View);
+						}
+						VectorStoreAligned(View, Views);
+
+						const int32 Channel = SubpixelChannels[Subpixel];
+						for (int32 Index = 0; Index < 4; ++Index)
+						{
+							const FColor& Texel = ViewRows[(int32)Views[Index]][TexelColumns[X + Index]];
+							((uint8*)&Out[X + Index])[Channel] = ((const uint8*)&Texel)[Channel];
+						}
+					}
+					for (int32 Index = 0; Index < 4; ++Index)
+					{
+						Out[X + Index].A = 255;
+					}
+				}
+			}
+
+			// Scalar path, and the tail of the vectorized one
+			for (; X < Width; ++X)
+			{
+				const float U = (X + 0.5f) * InvWidth;
+				for (int32 Subpixel = 0; Subpixel < 3; ++Subpixel)
+				{
+					const float Phase = U * Params.PhaseU + RowPhases[Subpixel];
+					const float Fraction = Phase - FMath::FloorToFloat(Phase);
+					int32 ViewIndex = FMath::Min((int32)(Fraction * NumViews), NumViews - 1);
+					if (Params.bInvertViews)
+					{
+						ViewIndex = NumViews - 1 - ViewIndex;
+					}
+
+					const int32 Channel = SubpixelChannels[Subpixel];
+					((uint8*)&Out[X])[Channel] = ((const uint8*)&ViewRows[ViewIndex][TexelColumns[X]])[Channel];
+				}
+				Out[X].A = 255;
+			}
+		};
+
+		ParallelFor(Height, InterleaveRow, !bParallel);
+	}
+
+	/*
+	 * Console commands
+	 */
+
+	// Current device calibration, or a typical one when running without a device
+	static FLenticularParams GetBenchmarkParams()
+	{
+		FLenticularParams Params;
+		if (!ILookingGlassRuntime::IsAvailable() || !Params.Init(ILookingGlassRuntime::Get().GetCurrentCalibration()))
+		{
+			FLGDeviceCalibration Calibration;
+			Calibration.Width = 1440;
+			Calibration.Height = 2560;
+			Calibration.DPI = 491.0f;
+			Calibration.Pitch = 80.7f;
+			Calibration.Slope = -6.6f;
+			Calibration.Center = 0.1f;
+			Params.Init(Calibration);
+		}
+		return Params;
+	}
+
+	static void RunBenchmark(const TArray<FString>& Args)
+	{
+		const int32 NumIterations = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 10;
+		const FLenticularParams Params = GetBenchmarkParams();
+		const FLookingGlassTilingQuality TilingValues = GetDefault<ULookingGlassSettings>()->GetTilingQualityFor(ELookingGlassQualitySettings::Q_GoPortrait);
+		const ELookingGlassQuiltOrder QuiltOrder = GetDefault<ULookingGlassSettings>()->LookingGlassRenderingSettings.QuiltOrder;
+
+		// Every texel holds its view and position, so a wrong fetch is visible in the output
+		TArray<FColor> Quilt;
+		Quilt.SetNumUninitialized(TilingValues.QuiltW * TilingValues.QuiltH);
+		for (int32 Index = 0; Index < Quilt.Num(); ++Index)
+		{
+			const int32 X = Index % TilingValues.QuiltW;
+			const int32 Y = Index / TilingValues.QuiltW;
+			Quilt[Index] = FColor((uint8)X, (uint8)Y, (uint8)(X / FMath::Max(TilingValues.TileSizeX, 1) + Y / FMath::Max(TilingValues.TileSizeY, 1) * TilingValues.TilesX), 255);
+		}
+
+		UE_LOG(LookingGlassLogGame, Display, TEXT("LookingGlass interleaver benchmark, %dx%d panel, %dx%d quilt with %d views, %d worker threads:"),
+			Params.ScreenSize.X, Params.ScreenSize.Y, TilingValues.QuiltW, TilingValues.QuiltH, TilingValues.GetNumTiles(), FTaskGraphInterface::Get().GetNumWorkerThreads());
+
+		TArray<FColor> Reference;
+		TArray<FColor> Image;
+		auto Measure = [&](const TCHAR* Name, bool bVectorized, bool bParallel)
+		{
+			const double StartTime = FPlatformTime::Seconds();
+			for (int32 Iteration = 0; Iteration < NumIterations; ++Iteration)
+			{
+				InterleaveQuilt(Params, Quilt.GetData(), TilingValues, QuiltOrder, Image, bVectorized, bParallel);
+			}
+			const double Time = (FPlatformTime::Seconds() - StartTime) / NumIterations;
+
+			if (Reference.Num() == 0)
+			{
+				Reference = Image;
+			}
+			int32 NumDifferent = 0;
+			for (int32 Index = 0; Index < Image.Num(); ++Index)
+			{
+				NumDifferent += Image[Index] != Reference[Index] ? 1 : 0;
+			}
+			UE_LOG(LookingGlassLogGame, Display, TEXT("  %-24s %8.2f ms, %d pixels differ from scalar"), Name, Time * 1000.0, NumDifferent);
+		};
+
+		Measure(TEXT("Scalar, single thread"), false, false);
+		Measure(TEXT("Scalar, parallel"), false, true);
+		Measure(TEXT("SIMD, single thread"), true, false);
+		Measure(TEXT("SIMD, parallel"), true, true);
+	}
+
+	// Parses tiling from "_qs<Columns>x<Rows>a<Aspect>" suffix which is added to quilt screenshot names
+	static bool ParseQuiltSuffix(const FString& FileName, FLookingGlassTilingQuality& OutTilingValues)
+	{
+		const FString BaseName = FPaths::GetBaseFilename(FileName);
+		const int32 SuffixStart = BaseName.Find(TEXT("_qs"), ESearchCase::IgnoreCase, ESearchDir::FromEnd);
+		if (SuffixStart == INDEX_NONE)
+		{
+			return false;
+		}
+
+		FString Columns, RowsAndAspect, Rows, Aspect;
+		if (!BaseName.Mid(SuffixStart + 3).Split(TEXT("x"), &Columns, &RowsAndAspect) || !RowsAndAspect.Split(TEXT("a"), &Rows, &Aspect))
+		{
+			return false;
+		}
+
+		OutTilingValues.TilesX = FCString::Atoi(*Columns);
+		OutTilingValues.TilesY = FCString::Atoi(*Rows);
+		OutTilingValues.Aspect = FCString::Atof(*Aspect);
+		return OutTilingValues.TilesX > 0 && OutTilingValues.TilesY > 0;
+	}
+
+	static void InterleaveQuiltFile(const TArray<FString>& Args)
+	{
+		if (Args.Num() < 1)
+		{
+			UE_LOG(LookingGlassLogGame, Warning, TEXT("Usage: LookingGlass.InterleaveQuilt QuiltFile [OutputFile]"));
+			return;
+		}
+		const FString& QuiltFile = Args[0];
+		const FString OutputFile = Args.Num() > 1 ? Args[1] : FPaths::GetBaseFilename(QuiltFile, false) + TEXT("_native.png");
+
+		FLenticularParams Params;
+		if (!Params.Init(ILookingGlassRuntime::Get().GetCurrentCalibration()))
+		{
+			UE_LOG(LookingGlassLogGame, Warning, TEXT("No device calibration, unable to interleave %s"), *QuiltFile);
+			return;
+		}
+
+		FLookingGlassTilingQuality TilingValues;
+		if (!ParseQuiltSuffix(QuiltFile, TilingValues))
+		{
+			UE_LOG(LookingGlassLogGame, Warning, TEXT("Quilt tiling is unknown, the file name should end with _qs<Columns>x<Rows>a<Aspect>: %s"), *QuiltFile);
+			return;
+		}
+
+		TArray<uint8> FileData;
+		if (!FFileHelper::LoadFileToArray(FileData, *QuiltFile))
+		{
+			UE_LOG(LookingGlassLogGame, Warning, TEXT("Unable to read %s"), *QuiltFile);
+			return;
+		}
+
+		IImageWrapperModule& ImageWrapperModule = FModuleManager::LoadModuleChecked<IImageWrapperModule>(TEXT("ImageWrapper"));
+		const EImageFormat Format = ImageWrapperModule.DetectImageFormat(FileData.GetData(), FileData.Num());
+		TSharedPtr<IImageWrapper> ImageWrapper = Format != EImageFormat::Invalid ? ImageWrapperModule.CreateImageWrapper(Format) : nullptr;
+		TArray64<uint8> RawData;
+		if (!ImageWrapper.IsValid() || !ImageWrapper->SetCompressed(FileData.GetData(), FileData.Num()) || !ImageWrapper->GetRaw(ERGBFormat::BGRA, 8, RawData))
+		{
+			UE_LOG(LookingGlassLogGame, Warning, TEXT("Unable to decode %s"), *QuiltFile);
+			return;
+		}
+
+		TilingValues.QuiltW = ImageWrapper->GetWidth();
+		TilingValues.QuiltH = ImageWrapper->GetHeight();
+		TilingValues.Setup();
+
+		const double StartTime = FPlatformTime::Seconds();
+		TArray<FColor> Image;
+		InterleaveQuilt(Params, (const FColor*)RawData.GetData(), TilingValues, GetDefault<ULookingGlassSettings>()->LookingGlassRenderingSettings.QuiltOrder, Image);
+		const double Time = FPlatformTime::Seconds() - StartTime;
+
+		TArray64<uint8> CompressedBitmap;
+		if (!ImageEncoder::EncodePNG(Image.GetData(), Params.ScreenSize.X, Params.ScreenSize.Y, CompressedBitmap) || !FFileHelper::SaveArrayToFile(CompressedBitmap, *OutputFile))
+		{
+			UE_LOG(LookingGlassLogGame, Warning, TEXT("Unable to write %s"), *OutputFile);
+			return;
+		}
+
+		UE_LOG(LookingGlassLogGame, Display, TEXT("Interleaved %s into %s (%dx%d) in %.1f ms"), *QuiltFile, *OutputFile, Params.ScreenSize.X, Params.ScreenSize.Y, Time * 1000.0);
+	}
+
+	// Works without a LookingGlass window or GPU, e.g. "UnrealEditor-Cmd <Project> -nullrhi -ExecCmds="LookingGlass.BenchmarkInterleaver,Quit""
+	static FAutoConsoleCommand BenchmarkInterleaverCommand(
+		TEXT("LookingGlass.BenchmarkInterleaver"),
+		TEXT("Compare SIMD and scalar CPU lenticular interleave of a synthetic quilt. Optional argument: number of iterations."),
+		FConsoleCommandWithArgsDelegate::CreateStatic(&RunBenchmark));
+
+	static FAutoConsoleCommand InterleaveQuiltCommand(
+		TEXT("LookingGlass.InterleaveQuilt"),
+		TEXT("Make a native panel image from a quilt screenshot, with calibration of the current device. Arguments: QuiltFile [OutputFile]."),
+		FConsoleCommandWithArgsDelegate::CreateStatic(&InterleaveQuiltFile));
+}
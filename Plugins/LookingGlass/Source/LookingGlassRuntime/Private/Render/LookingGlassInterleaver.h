@@ -0,0 +1,59 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "LookingGlassSettings.h"
+
+struct FLGDeviceCalibration;
+
+/**
+ * CPU version of the lenticular interleave, which Bridge performs on GPU when presenting the quilt. Every subpixel of
+ * the panel shows a single view of the quilt, selected by the phase of the lens above it. Used as a reference for the
+ * GPU output, and for making native panel images offline, without a device or GPU.
+ */
+
+namespace LookingGlass
+{
+	/**
+	 * Lenticular parameters derived from device calibration. The phase of a subpixel at screen UV (origin at the
+	 * bottom-left corner) is frac(U * PhaseU + V * PhaseV + Subpixel * PhaseSubpixel + PhaseBias), and it selects
+	 * the view floor(Phase * NumViews), counted from the other end when bInvertViews is set.
+	 */
+	struct FLenticularParams
+	{
+		// Panel resolution
+		FIntPoint ScreenSize = FIntPoint::ZeroValue;
+
+		float PhaseU = 0.0f;
+		float PhaseV = 0.0f;
+		float PhaseSubpixel = 0.0f;
+		float PhaseBias = 0.0f;
+		bool bInvertViews = false;
+
+		// Returns false when the calibration has no lenticular data, e.g. the default one used without a device
+		bool Init(const FLGDeviceCalibration& Calibration);
+
+		float GetPhase(float U, float V, int32 Subpixel) const
+		{
+			const float Phase = U * PhaseU + (V * PhaseV + PhaseBias + Subpixel * PhaseSubpixel);
+			return Phase - FMath::FloorToFloat(Phase);
+		}
+	};
+
+	/**
+	 * @fn	void InterleaveQuilt(const FLenticularParams& Params, const FColor* Quilt, const FLookingGlassTilingQuality& TilingValues, ELookingGlassQuiltOrder QuiltOrder, TArray<FColor>& OutImage, bool bVectorized = true, bool bParallel = true);
+	 *
+	 * @brief	Makes the native panel image from a quilt. Views are sampled with the nearest texel.
+	 *
+	 * @param 		  	Params			Lenticular parameters of the device.
+	 * @param 		  	Quilt			Quilt pixels, QuiltW * QuiltH of TilingValues.
+	 * @param 		  	TilingValues	Layout of the quilt.
+	 * @param 		  	QuiltOrder  	Order of views in the quilt.
+	 * @param [in,out]	OutImage		Panel image, ScreenSize of Params.
+	 * @param 		  	bVectorized 	Compute view indices 4 pixels at once with SIMD (SSE or NEON). The result is the
+	 * 									same as the scalar path, except for rounding at view boundaries.
+	 * @param 		  	bParallel   	Split scanlines between task graph workers.
+	 */
+
+	void InterleaveQuilt(const FLenticularParams& Params, const FColor* Quilt, const FLookingGlassTilingQuality& TilingValues, ELookingGlassQuiltOrder QuiltOrder,
+		TArray<FColor>& OutImage, bool bVectorized = true, bool bParallel = true);
+}
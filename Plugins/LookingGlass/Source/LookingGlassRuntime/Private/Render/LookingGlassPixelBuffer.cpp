@@ -0,0 +1,153 @@
+#include "Render/LookingGlassPixelBuffer.h"
+#include "Render/LookingGlassImagePixelData.h"
+
+#include "Misc/LookingGlassStats.h"
+
+/*
+ * FLookingGlassPixelBufferPool
+ */
+
+FLookingGlassPixelBufferPool& FLookingGlassPixelBufferPool::Get()
+{
+	static FLookingGlassPixelBufferPool Instance;
+	return Instance;
+}
+
+FLookingGlassPixelBufferRef FLookingGlassPixelBufferPool::Acquire(const FIntPoint& Size)
+{
+	const int64 NumPixels = (int64)Size.X * Size.Y;
+	FLookingGlassPixelBuffer* Buffer = nullptr;
+
+	{
+		FScopeLock Lock(&Mutex);
+
+		// Prefer a buffer which already has enough memory
+		for (int32 Index = IdleBuffers.Num() - 1; Index >= 0; Index--)
+		{
+			if (IdleBuffers[Index]->Pixels.Max() >= NumPixels)
+			{
+				Buffer = IdleBuffers[Index];
+				IdleBuffers.RemoveAtSwap(Index);
+				break;
+			}
+		}
+		if (Buffer == nullptr && IdleBuffers.Num() > 0)
+		{
+			Buffer = IdleBuffers.Pop();
+		}
+		if (Buffer == nullptr)
+		{
+			Buffer = new FLookingGlassPixelBuffer();
+		}
+
+		AllocatedBytes -= Buffer->Pixels.GetAllocatedSize();
+		Buffer->Pixels.SetNumUninitialized(NumPixels, EAllowShrinking::No);
+		AllocatedBytes += Buffer->Pixels.GetAllocatedSize();
+		NumUsedBuffers++;
+
+		UpdateStats();
+	}
+
+	Buffer->Size = Size;
+
+	// The buffer goes back to the pool when the last reference is gone
+	return MakeShareable(Buffer, [this](FLookingGlassPixelBuffer* InBuffer)
+	{
+		Release(InBuffer);
+	});
+}
+
+void FLookingGlassPixelBufferPool::Release(FLookingGlassPixelBuffer* Buffer)
+{
+	FScopeLock Lock(&Mutex);
+
+	NumUsedBuffers--;
+	if (IdleBuffers.Num() < MaxIdleBuffers)
+	{
+		IdleBuffers.Add(Buffer);
+	}
+	else
+	{
+		AllocatedBytes -= Buffer->Pixels.GetAllocatedSize();
+		delete Buffer;
+	}
+
+	UpdateStats();
+}
+
+void FLookingGlassPixelBufferPool::SetMaxIdleBuffers(int32 InMaxIdleBuffers)
+{
+	FScopeLock Lock(&Mutex);
+
+	MaxIdleBuffers = FMath::Max(InMaxIdleBuffers, 0);
+	while (IdleBuffers.Num() > MaxIdleBuffers)
+	{
+		FLookingGlassPixelBuffer* Buffer = IdleBuffers.Pop();
+		AllocatedBytes -= Buffer->Pixels.GetAllocatedSize();
+		delete Buffer;
+	}
+
+	UpdateStats();
+}
+
+void FLookingGlassPixelBufferPool::Trim()
+{
+	FScopeLock Lock(&Mutex);
+
+	for (FLookingGlassPixelBuffer* Buffer : IdleBuffers)
+	{
+		AllocatedBytes -= Buffer->Pixels.GetAllocatedSize();
+		delete Buffer;
+	}
+	IdleBuffers.Empty();
+
+	UpdateStats();
+}
+
+int64 FLookingGlassPixelBufferPool::GetAllocatedBytes() const
+{
+	FScopeLock Lock(&Mutex);
+	return AllocatedBytes;
+}
+
+void FLookingGlassPixelBufferPool::UpdateStats() const
+{
+	SET_DWORD_STAT(STAT_PixelBuffersInUse, NumUsedBuffers);
+	SET_FLOAT_STAT(STAT_PixelBufferMemory, AllocatedBytes / (1024.0 * 1024.0));
+}
+
+/*
+ * FLookingGlassImagePixelData
+ */
+
+FLookingGlassImagePixelData::FLookingGlassImagePixelData(const FLookingGlassPixelBufferRef& InBuffer, FImagePixelPayloadPtr InPayload)
+	: FImagePixelData(InBuffer->Size, EImagePixelType::Color, ERGBFormat::BGRA, 8, 4, InPayload)
+	, Buffer(InBuffer)
+	, SharedPayload(InPayload)
+{
+}
+
+TUniquePtr<FImagePixelData> FLookingGlassImagePixelData::Move()
+{
+	// Both objects will reference the same buffer, it is never copied
+	return MakeUnique<FLookingGlassImagePixelData>(Buffer, SharedPayload);
+}
+
+TUniquePtr<FImagePixelData> FLookingGlassImagePixelData::Copy() const
+{
+	FLookingGlassPixelBufferRef NewBuffer = FLookingGlassPixelBufferPool::Get().Acquire(Buffer->Size);
+	FMemory::Memcpy(NewBuffer->Pixels.GetData(), Buffer->Pixels.GetData(), Buffer->Pixels.Num() * sizeof(FColor));
+	return MakeUnique<FLookingGlassImagePixelData>(NewBuffer);
+}
+
+void FLookingGlassImagePixelData::RetrieveData(const void*& OutDataPtr, int64& OutSizeBytes) const
+{
+	OutDataPtr = Buffer->Pixels.GetData();
+	OutSizeBytes = Buffer->Pixels.Num() * sizeof(FColor);
+}
+
+void FLookingGlassImagePixelData::RetrieveData(void*& OutDataPtr, int64& OutSizeBytes)
+{
+	OutDataPtr = Buffer->Pixels.GetData();
+	OutSizeBytes = Buffer->Pixels.Num() * sizeof(FColor);
+}
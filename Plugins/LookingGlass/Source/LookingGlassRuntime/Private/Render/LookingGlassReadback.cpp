@@ -0,0 +1,188 @@
+#include "Render/LookingGlassReadback.h"
+
+#include "Misc/LookingGlassLog.h"
+#include "Misc/LookingGlassStats.h"
+
+#include "RenderingThread.h"
+#include "RHIGPUReadback.h"
+
+#include "Runtime/Launch/Resources/Version.h"
+
+using namespace LookingGlass;
+
+FQuiltReadbackSlot::~FQuiltReadbackSlot()
+{
+}
+
+FQuiltReadbackRing::FQuiltReadbackRing(int32 InRingSize)
+	: State(MakeShared<FState, ESPMode::ThreadSafe>())
+{
+	State->Slots.SetNum(FMath::Max(InRingSize, 1));
+	for (FQuiltReadbackSlotPtr& Slot : State->Slots)
+	{
+		Slot = MakeShared<FQuiltReadbackSlot, ESPMode::ThreadSafe>();
+	}
+}
+
+FQuiltReadbackRing::~FQuiltReadbackRing()
+{
+	Flush();
+
+	// Readback objects should be released on rendering thread
+	ENQUEUE_RENDER_COMMAND(ReleaseQuiltReadbacks)(
+		[State = State](FRHICommandListImmediate& RHICmdList)
+		{
+			State->Slots.Empty();
+		});
+}
+
+FQuiltReadbackSlotPtr FQuiltReadbackRing::BeginReadback(FOnReadbackComplete&& OnComplete)
+{
+	check(IsInGameThread());
+
+	if (State->NumInFlight.GetValue() >= GetRingSize())
+	{
+		// All slots are busy, wait for the oldest one. This happens when GPU is more than RingSize frames behind.
+		SCOPE_CYCLE_COUNTER(STAT_WaitForReadback_GameThread);
+		while (State->NumInFlight.GetValue() >= GetRingSize())
+		{
+			EnqueuePoll();
+			FlushRenderingCommands();
+			DispatchCompleted();
+			if (State->NumInFlight.GetValue() >= GetRingSize())
+			{
+				FPlatformProcess::Sleep(0.001f);
+			}
+		}
+	}
+
+	const int32 SlotIndex = NextSlotIndex;
+	NextSlotIndex = (NextSlotIndex + 1) % GetRingSize();
+
+	State->NumInFlight.Increment();
+	PendingCallbacks.Add(MoveTemp(OnComplete));
+
+	ENQUEUE_RENDER_COMMAND(BeginQuiltReadback)(
+		[State = State, SlotIndex](FRHICommandListImmediate& RHICmdList)
+		{
+			State->Slots[SlotIndex]->bCopyEnqueued = false;
+			State->InFlightSlots.Add(SlotIndex);
+		});
+
+	SET_DWORD_STAT(STAT_QuiltReadbacksInFlight, State->NumInFlight.GetValue());
+
+	return State->Slots[SlotIndex];
+}
+
+void FQuiltReadbackRing::Tick()
+{
+	check(IsInGameThread());
+
+	// Results of this poll will be dispatched on the next tick
+	DispatchCompleted();
+	if (State->NumInFlight.GetValue() > 0)
+	{
+		EnqueuePoll();
+	}
+}
+
+void FQuiltReadbackRing::Flush()
+{
+	check(IsInGameThread());
+
+	while (State->NumInFlight.GetValue() > 0)
+	{
+		EnqueuePoll();
+		FlushRenderingCommands();
+		DispatchCompleted();
+		if (State->NumInFlight.GetValue() > 0)
+		{
+			FPlatformProcess::Sleep(0.001f);
+		}
+	}
+}
+
+void FQuiltReadbackRing::EnqueuePoll()
+{
+	ENQUEUE_RENDER_COMMAND(PollQuiltReadbacks)(
+		[State = State](FRHICommandListImmediate& RHICmdList)
+		{
+			State->Poll_RenderThread(RHICmdList);
+		});
+}
+
+void FQuiltReadbackRing::DispatchCompleted()
+{
+	FLookingGlassPixelBufferPtr Result;
+	while (State->Completed.Dequeue(Result))
+	{
+		check(PendingCallbacks.Num() > 0);
+		FOnReadbackComplete OnComplete = MoveTemp(PendingCallbacks[0]);
+		PendingCallbacks.RemoveAt(0);
+
+		if (OnComplete)
+		{
+			OnComplete(Result);
+		}
+	}
+
+	SET_DWORD_STAT(STAT_QuiltReadbacksInFlight, State->NumInFlight.GetValue());
+}
+
+void FQuiltReadbackRing::FState::Poll_RenderThread(FRHICommandListImmediate& RHICmdList)
+{
+	check(IsInRenderingThread());
+
+	// Complete readbacks in order, so the oldest one blocks the rest
+	while (InFlightSlots.Num() > 0)
+	{
+		FQuiltReadbackSlot& Slot = *Slots[InFlightSlots[0]];
+
+		FLookingGlassPixelBufferPtr Result;
+
+		if (Slot.bCopyEnqueued && Slot.Readback.IsValid())
+		{
+			if (!Slot.Readback->IsReady())
+			{
+				break;
+			}
+
+			SCOPE_CYCLE_COUNTER(STAT_QuiltReadbackCopy_RenderThread);
+
+			int32 RowPitchInPixels = 0;
+#if (ENGINE_MAJOR_VERSION == 5) && (ENGINE_MINOR_VERSION >= 1)
+			const FColor* Data = (const FColor*)Slot.Readback->Lock(RowPitchInPixels);
+#else
+			void* LockedData = nullptr;
+			Slot.Readback->LockTexture(RHICmdList, LockedData, RowPitchInPixels);
+			const FColor* Data = (const FColor*)LockedData;
+#endif
+			if (Data != nullptr)
+			{
+				// This is the only copy of the frame on CPU side, the buffer is passed to consumers by reference
+				Result = FLookingGlassPixelBufferPool::Get().Acquire(Slot.Size);
+				for (int32 Y = 0; Y < Slot.Size.Y; Y++)
+				{
+					const FColor* Src = Data + (int64)Y * RowPitchInPixels;
+					FColor* Dst = Result->Pixels.GetData() + (int64)Y * Slot.Size.X;
+					for (int32 X = 0; X < Slot.Size.X; X++)
+					{
+						// Quilt's alpha is not meaningful, write the full one (same as ReadPixels based screenshots did)
+						Dst[X] = Src[X];
+						Dst[X].A = 255;
+					}
+				}
+			}
+			else
+			{
+				UE_LOG(LookingGlassLogRender, Warning, TEXT("Failed to lock quilt readback buffer"));
+			}
+			Slot.Readback->Unlock();
+		}
+
+		Slot.bCopyEnqueued = false;
+		InFlightSlots.RemoveAt(0);
+		Completed.Enqueue(MoveTemp(Result));
+		NumInFlight.Decrement();
+	}
+}
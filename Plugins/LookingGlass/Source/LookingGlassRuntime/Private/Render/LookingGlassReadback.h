@@ -0,0 +1,109 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Queue.h"
+#include "HAL/ThreadSafeCounter.h"
+
+#include "Render/LookingGlassPixelBuffer.h"
+
+class FRHIGPUTextureReadback;
+class FRHICommandListImmediate;
+
+namespace LookingGlass
+{
+	/**
+	 * A single readback of the quilt. The frame graph converts the quilt to 8-bit color and enqueues a copy into
+	 * Readback; the CPU side reads the data a few frames later, when the GPU is done with it.
+	 */
+	struct FQuiltReadbackSlot
+	{
+		~FQuiltReadbackSlot();
+
+		// Created on rendering thread on first use and reused after that
+		TUniquePtr<FRHIGPUTextureReadback> Readback;
+
+		// Size of the copied image, set when the copy is enqueued
+		FIntPoint Size = FIntPoint::ZeroValue;
+
+		// Set by the frame graph. When the graph skipped the copy, the readback completes with an empty image.
+		bool bCopyEnqueued = false;
+	};
+
+	typedef TSharedPtr<FQuiltReadbackSlot, ESPMode::ThreadSafe> FQuiltReadbackSlotPtr;
+
+	/**
+	 * @class	FQuiltReadbackRing
+	 *
+	 * @brief	Ring of asynchronous GPU readbacks, used for quilt screenshots and movie capture instead of blocking
+	 * 			FRenderTarget::ReadPixels. Readbacks are polled on rendering thread, and completion callbacks are
+	 * 			called on game thread from Tick(), in the same order the readbacks were started.
+	 */
+
+	class FQuiltReadbackRing
+	{
+	public:
+		// Buffer is null when the readback has failed
+		typedef TFunction<void(const FLookingGlassPixelBufferPtr& /* Buffer */)> FOnReadbackComplete;
+
+		explicit FQuiltReadbackRing(int32 InRingSize);
+
+		// Waits for all pending readbacks and calls their callbacks
+		~FQuiltReadbackRing();
+
+		int32 GetRingSize() const
+		{
+			return State->Slots.Num();
+		}
+
+		int32 GetNumInFlight() const
+		{
+			return State->NumInFlight.GetValue();
+		}
+
+		/**
+		 * @fn	FQuiltReadbackSlotPtr FQuiltReadbackRing::BeginReadback(FOnReadbackComplete&& OnComplete);
+		 *
+		 * @brief	Reserves a readback slot, which should be passed to the frame graph. Blocks when all slots are in flight.
+		 *
+		 * @param	OnComplete	Called on game thread with the image data.
+		 *
+		 * @returns	The slot to be filled by rendering thread.
+		 */
+
+		FQuiltReadbackSlotPtr BeginReadback(FOnReadbackComplete&& OnComplete);
+
+		// Poll readbacks on rendering thread, and call callbacks for completed ones. Should be called every frame.
+		void Tick();
+
+		// Wait for all readbacks which are in flight
+		void Flush();
+
+	private:
+		// Part of the ring which is accessed from rendering thread
+		struct FState
+		{
+			TArray<FQuiltReadbackSlotPtr> Slots;
+
+			// Rendering thread: indices of slots in flight, in order of submission
+			TArray<int32> InFlightSlots;
+
+			// Produced by rendering thread, consumed by game thread
+			TQueue<FLookingGlassPixelBufferPtr, EQueueMode::Spsc> Completed;
+
+			FThreadSafeCounter NumInFlight;
+
+			void Poll_RenderThread(FRHICommandListImmediate& RHICmdList);
+		};
+
+		void EnqueuePoll();
+
+		void DispatchCompleted();
+
+		TSharedRef<FState, ESPMode::ThreadSafe> State;
+
+		// Game thread: callbacks of readbacks in flight, in order of submission
+		TArray<FOnReadbackComplete> PendingCallbacks;
+
+		int32 NextSlotIndex = 0;
+	};
+}
@@ -0,0 +1,120 @@
+#include "Render/LookingGlassRenderTargetPool.h"
+
+#include "Misc/LookingGlassLog.h"
+#include "Misc/LookingGlassStats.h"
+
+#include "Engine/TextureRenderTarget2D.h"
+#include "UObject/Package.h"
+
+UTextureRenderTarget2D* FLookingGlassRenderTargetPool::Acquire(const FIntPoint& Size, EPixelFormat Format)
+{
+	check(IsInGameThread());
+
+	if (IdleTime > 0.0)
+	{
+		Trim(IdleTime);
+	}
+
+	const int64 Bytes = GetTextureBytes(Size, Format);
+
+	UTextureRenderTarget2D* RenderTarget = nullptr;
+	for (int32 Index = IdleTargets.Num() - 1; Index >= 0; Index--)
+	{
+		UTextureRenderTarget2D* Candidate = IdleTargets[Index].RenderTarget;
+		if (Candidate->SizeX == Size.X && Candidate->SizeY == Size.Y && Candidate->OverrideFormat == Format)
+		{
+			RenderTarget = Candidate;
+			IdleTargets.RemoveAtSwap(Index);
+			IdleBytes -= Bytes;
+			break;
+		}
+	}
+
+	if (RenderTarget == nullptr)
+	{
+		// Make a new UTextureRenderTarget2D object. Note: adding RF_TextExportTransient to not let it go to Copy or Duplicate
+		// operation, plus it bypasses a warning in UTextureRenderTarget2D::PostEditChangeProperty saying that RT is very large.
+		const FName TargetName = MakeUniqueObjectName(GetTransientPackage(), UTextureRenderTarget2D::StaticClass(), TEXT("LookingGlassRT"));
+		RenderTarget = NewObject<UTextureRenderTarget2D>(GetTransientPackage(), TargetName, RF_Transient | RF_TextExportTransient);
+		RenderTarget->ClearColor = FLinearColor::Red;
+		RenderTarget->InitCustomFormat(Size.X, Size.Y, Format, false);
+		RenderTarget->UpdateResourceImmediate();
+
+		UE_LOG(LookingGlassLogGame, Verbose, TEXT("Render target pool: allocated %dx%d %s"), Size.X, Size.Y, GPixelFormats[Format].Name);
+	}
+
+	LeasedTargets.Add(RenderTarget);
+	LeasedBytes += Bytes;
+	UpdateStats();
+
+	return RenderTarget;
+}
+
+void FLookingGlassRenderTargetPool::Release(UTextureRenderTarget2D* RenderTarget)
+{
+	check(IsInGameThread());
+
+	if (RenderTarget == nullptr || LeasedTargets.RemoveSingleSwap(RenderTarget) == 0)
+	{
+		return;
+	}
+
+	const int64 Bytes = GetTextureBytes(FIntPoint(RenderTarget->SizeX, RenderTarget->SizeY), RenderTarget->OverrideFormat);
+	LeasedBytes -= Bytes;
+	IdleBytes += Bytes;
+	IdleTargets.Add({ RenderTarget, FPlatformTime::Seconds() });
+
+	if (IdleTime > 0.0)
+	{
+		Trim(IdleTime);
+	}
+	else
+	{
+		UpdateStats();
+	}
+}
+
+void FLookingGlassRenderTargetPool::Trim(double MaxIdleTime)
+{
+	const double Now = FPlatformTime::Seconds();
+	for (int32 Index = IdleTargets.Num() - 1; Index >= 0; Index--)
+	{
+		if (Now - IdleTargets[Index].ReleaseTime < MaxIdleTime)
+		{
+			continue;
+		}
+
+		// Not referenced anymore, so the garbage collector frees it
+		UTextureRenderTarget2D* RenderTarget = IdleTargets[Index].RenderTarget;
+		IdleBytes -= GetTextureBytes(FIntPoint(RenderTarget->SizeX, RenderTarget->SizeY), RenderTarget->OverrideFormat);
+		RenderTarget->ReleaseResource();
+		IdleTargets.RemoveAtSwap(Index);
+	}
+	UpdateStats();
+}
+
+void FLookingGlassRenderTargetPool::AddReferencedObjects(FReferenceCollector& Collector)
+{
+	for (FIdleTarget& IdleTarget : IdleTargets)
+	{
+		Collector.AddReferencedObject(IdleTarget.RenderTarget);
+	}
+	Collector.AddReferencedObjects(LeasedTargets);
+}
+
+FString FLookingGlassRenderTargetPool::GetReferencerName() const
+{
+	return TEXT("FLookingGlassRenderTargetPool");
+}
+
+int64 FLookingGlassRenderTargetPool::GetTextureBytes(const FIntPoint& Size, EPixelFormat Format)
+{
+	return (int64)Size.X * Size.Y * GPixelFormats[Format].BlockBytes;
+}
+
+void FLookingGlassRenderTargetPool::UpdateStats() const
+{
+	SET_DWORD_STAT(STAT_RenderTargetsLeased, LeasedTargets.Num());
+	SET_DWORD_STAT(STAT_RenderTargetsIdle, IdleTargets.Num());
+	SET_FLOAT_STAT(STAT_RenderTargetPoolMemory, (LeasedBytes + IdleBytes) / (1024.0 * 1024.0));
+}
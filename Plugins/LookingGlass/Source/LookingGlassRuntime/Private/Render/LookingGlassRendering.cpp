@@ -1,8 +1,11 @@
 #include "Render/LookingGlassRendering.h"
+#include "Render/LookingGlassShaders.h"
+#include "Render/LookingGlassViewSynthesis.h"
 #include "Game/LookingGlassSceneCaptureComponent2D.h"
 
 #include "ILookingGlassRuntime.h"
 #include "Misc/LookingGlassLog.h"
+#include "Misc/LookingGlassStats.h"
 
 #include "GlobalShader.h"
 #include "PipelineStateCache.h"
@@ -10,9 +13,16 @@
 #include "TextureResource.h"
 #include "ScreenRendering.h"
 #include "CommonRenderResources.h"
+#include "RenderGraphBuilder.h"
+#include "RenderGraphUtils.h"
+#include "RenderTargetPool.h"
+#include "RHIGPUReadback.h"
+#include "UnrealClient.h"
 
 #include "Runtime/Launch/Resources/Version.h"
 
+DECLARE_GPU_STAT_NAMED(CopyToQuiltBatched, TEXT("Copy to quilt (batched)"));
+
 void LookingGlass::CopyToQuiltShader_RenderThread(FRHICommandListImmediate& RHICmdList, const FCopyToQuiltRenderContext& Context)
 {
     check(IsInRenderingThread());
@@ -27,57 +37,10 @@ void LookingGlass::CopyToQuiltShader_RenderThread(FRHICommandListImmediate& RHIC
     RHICmdList.BeginRenderPass(RPInfo, TEXT("CopyToQuiltShader_RenderThread"));
 
     // Set Viewport for tiling ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-    // Support four scanning orders for quilt tiles
-    int32 X = 0;
-    int32 Y = 0;
-    switch (Context.QuiltOrder)
-    {
-    case ELookingGlassQuiltOrder::TopLeft_To_BottomRight:
-    {
-        // Row-major from top-left to bottom-right
-        const int32 Row = Context.CurrentViewIndex / TilingValues.TilesX; // 0 is top row
-        const int32 Col = Context.CurrentViewIndex % TilingValues.TilesX;
-        X = Col * TilingValues.TileSizeX;
-        Y = Row * TilingValues.TileSizeY;
-        break;
-    }
-    case ELookingGlassQuiltOrder::BottomLeft_To_TopRight:
-    {
-        // Legacy behavior: bottom-left to top-right
-        const int32 RI = TilingValues.GetNumTiles() - Context.CurrentViewIndex - 1;
-        X = (Context.CurrentViewIndex % TilingValues.TilesX) * TilingValues.TileSizeX;
-        Y = (RI / TilingValues.TilesX) * TilingValues.TileSizeY;
-        break;
-    }
-    case ELookingGlassQuiltOrder::TopRight_To_BottomLeft:
-    {
-        // Row-major from top-right to bottom-left
-        const int32 Row = Context.CurrentViewIndex / TilingValues.TilesX; // 0 is top row
-        const int32 ColFromRight = Context.CurrentViewIndex % TilingValues.TilesX;
-        const int32 Col = (TilingValues.TilesX - 1) - ColFromRight;
-        X = Col * TilingValues.TileSizeX;
-        Y = Row * TilingValues.TileSizeY;
-        break;
-    }
-    case ELookingGlassQuiltOrder::BottomRight_To_TopLeft:
-    {
-        // Row-major from bottom-right to top-left
-        const int32 RowFromBottom = Context.CurrentViewIndex / TilingValues.TilesX;
-        const int32 Row = (TilingValues.TilesY - 1) - RowFromBottom;
-        const int32 ColFromRight = Context.CurrentViewIndex % TilingValues.TilesX;
-        const int32 Col = (TilingValues.TilesX - 1) - ColFromRight;
-        X = Col * TilingValues.TileSizeX;
-        Y = Row * TilingValues.TileSizeY;
-        break;
-    }
-    default:
-        break;
-    }
-
-    // The padding is necessary because the shader takes y from the opposite spot as this does
-    int32 PaddingY = TilingValues.QuiltH - TilingValues.TilesY * TilingValues.TileSizeY;
-    FVector2D Min(X, Y + PaddingY);
-    FVector2D Max(Min.X + TilingValues.TileSizeX, Min.Y + TilingValues.TileSizeY);
+    FIntRect TileRect;
+    FLookingGlassRenderingConfig::CalculateQuiltTileRect(TileRect, TilingValues, Context.QuiltOrder, Context.CurrentViewIndex);
+    FVector2D Min(TileRect.Min.X, TileRect.Min.Y);
+    FVector2D Max(TileRect.Max.X, TileRect.Max.Y);
 
     UE_LOG(LookingGlassLogRender, Verbose, TEXT("CurrentView %d, Min %s Max %s"), Context.CurrentViewIndex, *Min.ToString(), *Max.ToString());
 
@@ -114,6 +77,8 @@ void LookingGlass::CopyToQuiltShader_RenderThread(FRHICommandListImmediate& RHIC
     // Calculate view rect
     float U = 0.f, V = 0.f, SizeU = 1.f, SizeV = 1.f;
     FLookingGlassRenderingConfig::CalculateViewRect(U, V, SizeU, SizeV, Context.ViewRows, Context.ViewColumns, Context.TotalViews, Context.ViewInfoIndex);
+    SizeU *= Context.ViewScale.X;
+    SizeV *= Context.ViewScale.Y;
 
 
     // Update shader parameters and resources parameters. END --------------------------------------
@@ -135,3 +100,501 @@ void LookingGlass::CopyToQuiltShader_RenderThread(FRHICommandListImmediate& RHIC
     RHICmdList.EndRenderPass();
 }
 
+
+namespace LookingGlass
+{
+    // Collects passes and textures of the frame graph, for LookingGlass.DumpGraph command
+    struct FFrameGraphDump
+    {
+        bool bEnabled = false;
+        TArray<FString> Lines;
+        int64 TransientBytes = 0;
+        int64 ExternalBytes = 0;
+
+        void AddTexture(FRDGTextureRef Texture, bool bTransient)
+        {
+            if (!bEnabled)
+            {
+                return;
+            }
+            const FRDGTextureDesc& Desc = Texture->Desc;
+            const int64 Bytes = (int64)Desc.Extent.X * Desc.Extent.Y * GPixelFormats[Desc.Format].BlockBytes;
+            (bTransient ? TransientBytes : ExternalBytes) += Bytes;
+            Lines.Add(FString::Printf(TEXT("  texture %-28s %s %dx%d %s %.2f MB"), Texture->Name,
+                bTransient ? TEXT("transient") : TEXT("external "), Desc.Extent.X, Desc.Extent.Y,
+                GPixelFormats[Desc.Format].Name, Bytes / (1024.0 * 1024.0)));
+        }
+
+        void AddPass(const TCHAR* Name, int32 NumDraws)
+        {
+            if (bEnabled)
+            {
+                Lines.Add(FString::Printf(TEXT("  pass    %-28s draws %d"), Name, NumDraws));
+            }
+        }
+
+        void Log() const
+        {
+            if (!bEnabled)
+            {
+                return;
+            }
+            UE_LOG(LookingGlassLogRender, Display, TEXT("LookingGlass frame graph, transient memory %.2f MB, external textures %.2f MB:"),
+                TransientBytes / (1024.0 * 1024.0), ExternalBytes / (1024.0 * 1024.0));
+            for (const FString& Line : Lines)
+            {
+                UE_LOG(LookingGlassLogRender, Display, TEXT("%s"), *Line);
+            }
+        }
+    };
+
+    static FRDGTextureRef RegisterTexture(FRDGBuilder& GraphBuilder, FRHITexture* Texture, const TCHAR* Name, FFrameGraphDump& Dump)
+    {
+        FRDGTextureRef Result = GraphBuilder.RegisterExternalTexture(CreateRenderTarget(Texture, Name));
+        Dump.AddTexture(Result, false);
+        return Result;
+    }
+
+    // A batch of views copied from one source texture with a single instanced draw
+    struct FQuiltCopyDraw
+    {
+        FRDGTextureRef Source;
+        TArray<FVector4f, TInlineAllocator<FLookingGlassRenderingConfig::MaxView>> DestRects;
+        TArray<FVector4f, TInlineAllocator<FLookingGlassRenderingConfig::MaxView>> SourceRects;
+    };
+
+    // Adds a raster pass which draws all the batches into Target, with a single pipeline state
+    static void AddQuiltCopyPass(FRDGBuilder& GraphBuilder, FRDGEventName&& PassName, const TCHAR* DumpName, FRDGTextureRef Target, TArray<FQuiltCopyDraw>&& Draws, bool bBilinear, FFrameGraphDump& Dump)
+    {
+        FLookingGlassQuiltCopyPassParameters* PassParameters = GraphBuilder.AllocParameters<FLookingGlassQuiltCopyPassParameters>();
+        for (const FQuiltCopyDraw& Draw : Draws)
+        {
+            PassParameters->SourceTextures.AddUnique(FRDGTextureAccess(Draw.Source, ERHIAccess::SRVGraphics));
+        }
+        PassParameters->RenderTargets[0] = FRenderTargetBinding(Target, ERenderTargetLoadAction::ELoad);
+
+        Dump.AddPass(DumpName, Draws.Num());
+
+        const FIntPoint TargetSize = Target->Desc.Extent;
+        GraphBuilder.AddPass(
+            MoveTemp(PassName),
+            PassParameters,
+            ERDGPassFlags::Raster,
+            [Draws = MoveTemp(Draws), TargetSize, bBilinear](FRHICommandList& RHICmdList)
+            {
+                RHICmdList.SetViewport(0, 0, 0.0f, (float)TargetSize.X, (float)TargetSize.Y, 1.0f);
+
+                auto ShaderMap = GetGlobalShaderMap(GMaxRHIFeatureLevel);
+                TShaderMapRef<FLookingGlassQuiltCopyVS> VertexShader(ShaderMap);
+                TShaderMapRef<FLookingGlassQuiltCopyPS> PixelShader(ShaderMap);
+
+                // Set the graphic pipeline state once for all draws
+                FGraphicsPipelineStateInitializer GraphicsPSOInit;
+                RHICmdList.ApplyCachedRenderTargets(GraphicsPSOInit);
+                GraphicsPSOInit.BlendState = TStaticBlendState<>::GetRHI();
+                GraphicsPSOInit.RasterizerState = TStaticRasterizerState<>::GetRHI();
+                GraphicsPSOInit.DepthStencilState = TStaticDepthStencilState<false, CF_Always>::GetRHI();
+                // Vertices are generated from SV_VertexID and SV_InstanceID
+                GraphicsPSOInit.BoundShaderState.VertexDeclarationRHI = GEmptyVertexDeclaration.VertexDeclarationRHI;
+                GraphicsPSOInit.BoundShaderState.VertexShaderRHI = VertexShader.GetVertexShader();
+                GraphicsPSOInit.BoundShaderState.PixelShaderRHI = PixelShader.GetPixelShader();
+                GraphicsPSOInit.PrimitiveType = PT_TriangleList;
+                SetGraphicsPipelineState(RHICmdList, GraphicsPSOInit, 0);
+
+                for (const FQuiltCopyDraw& Draw : Draws)
+                {
+                    check(Draw.DestRects.Num() <= FLookingGlassRenderingConfig::MaxView);
+
+                    FLookingGlassQuiltCopyVS::FParameters VSParameters;
+                    VSParameters.InvTargetSize = FVector2f(1.0f / TargetSize.X, 1.0f / TargetSize.Y);
+                    for (int32 Index = 0; Index < Draw.DestRects.Num(); ++Index)
+                    {
+                        VSParameters.DestRects[Index] = Draw.DestRects[Index];
+                        VSParameters.SourceRects[Index] = Draw.SourceRects[Index];
+                    }
+
+                    FLookingGlassQuiltCopyPS::FParameters PSParameters;
+                    PSParameters.SourceTexture = Draw.Source->GetRHI();
+                    PSParameters.SourceSampler = bBilinear ? TStaticSamplerState<SF_Bilinear>::GetRHI() : TStaticSamplerState<SF_Point>::GetRHI();
+
+                    SetShaderParameters(RHICmdList, VertexShader, VertexShader.GetVertexShader(), VSParameters);
+                    SetShaderParameters(RHICmdList, PixelShader, PixelShader.GetPixelShader(), PSParameters);
+
+                    // Two triangles per view, one instance per view
+                    RHICmdList.DrawPrimitive(0, 2, Draw.DestRects.Num());
+                }
+            });
+    }
+
+    // Stretches Source over the whole Target
+    static void AddImageCopyPass(FRDGBuilder& GraphBuilder, FRDGEventName&& PassName, const TCHAR* DumpName, FRDGTextureRef Source, FRDGTextureRef Target, FFrameGraphDump& Dump)
+    {
+        FQuiltCopyDraw Draw;
+        Draw.Source = Source;
+        Draw.DestRects.Add(FVector4f(0.0f, 0.0f, Target->Desc.Extent.X, Target->Desc.Extent.Y));
+        Draw.SourceRects.Add(FVector4f(0.0f, 0.0f, 1.0f, 1.0f));
+
+        TArray<FQuiltCopyDraw> Draws;
+        Draws.Add(MoveTemp(Draw));
+
+        const bool bBilinear = Source->Desc.Extent != Target->Desc.Extent;
+        AddQuiltCopyPass(GraphBuilder, MoveTemp(PassName), DumpName, Target, MoveTemp(Draws), bBilinear, Dump);
+    }
+
+    // Interleaves views of the Source quilt into Target, which covers the whole panel
+    static void AddLenticularPass(FRDGBuilder& GraphBuilder, FRDGTextureRef Source, FRDGTextureRef Target, const FFrameGraphDesc& Desc, FFrameGraphDump& Dump)
+    {
+        const FLenticularDesc& Lenticular = Desc.Lenticular;
+        const FIntPoint Tiles = Lenticular.Tiles.ComponentMax(FIntPoint(1, 1));
+        const FIntPoint SourceSize = Source->Desc.Extent;
+        const FIntPoint TargetSize = Target->Desc.Extent;
+
+        FLookingGlassLenticularPS::FParameters PSParameters;
+        PSParameters.PhaseU = Lenticular.Params.PhaseU;
+        PSParameters.PhaseV = Lenticular.Params.PhaseV;
+        PSParameters.PhaseBias = Lenticular.Params.PhaseBias;
+        PSParameters.NumViews = Tiles.X * Tiles.Y;
+        PSParameters.bInvertViews = Lenticular.Params.bInvertViews ? 1 : 0;
+        PSParameters.ScreenSize = FVector2f(TargetSize.X, TargetSize.Y);
+        PSParameters.Tiles = FUintVector2(Tiles.X, Tiles.Y);
+        if (Tiles == FIntPoint(1, 1))
+        {
+            PSParameters.TileSize = FVector2f(1.0f, 1.0f);
+            PSParameters.TileOffset = FVector2f(0.0f, 0.0f);
+        }
+        else
+        {
+            PSParameters.TileSize = FVector2f((float)Desc.TilingValues.TileSizeX / SourceSize.X, (float)Desc.TilingValues.TileSizeY / SourceSize.Y);
+            // Tiles are shifted down by the rows of the quilt which they don't cover, as in CalculateQuiltTileRect
+            const int32 PaddingY = Desc.TilingValues.QuiltH - Desc.TilingValues.TilesY * Desc.TilingValues.TileSizeY;
+            PSParameters.TileOffset = FVector2f(0.0f, (float)PaddingY / SourceSize.Y);
+        }
+        // Same tile order as FLookingGlassRenderingConfig::CalculateQuiltTileRect
+        const bool bFlipColumns = Desc.QuiltOrder == ELookingGlassQuiltOrder::TopRight_To_BottomLeft || Desc.QuiltOrder == ELookingGlassQuiltOrder::BottomRight_To_TopLeft;
+        const bool bFlipRows = Desc.QuiltOrder == ELookingGlassQuiltOrder::BottomLeft_To_TopRight || Desc.QuiltOrder == ELookingGlassQuiltOrder::BottomRight_To_TopLeft;
+        PSParameters.FlipTiles = FUintVector2(bFlipColumns ? 1 : 0, bFlipRows ? 1 : 0);
+
+        // Subpixel phase offset of the RGB stripe is the same as a horizontal offset of a third of a pixel per subpixel
+        const int32 NumCells = FMath::Min(Lenticular.SubpixelCells.Num(), FLookingGlassLenticularPS::MaxSubpixelCells);
+        for (int32 Index = 0; Index < FMath::Max(NumCells, 1); ++Index)
+        {
+            const FLGSubpixelCell Cell = NumCells > 0 ? Lenticular.SubpixelCells[Index] : FLGSubpixelCell{ 0.0f, 0.0f, 1.0f / 3.0f, 0.0f, 2.0f / 3.0f, 0.0f };
+            PSParameters.SubpixelCells[Index * 2] = FVector4f(Cell.ROffsetX, Cell.ROffsetY, Cell.GOffsetX, Cell.GOffsetY);
+            PSParameters.SubpixelCells[Index * 2 + 1] = FVector4f(Cell.BOffsetX, Cell.BOffsetY, 0.0f, 0.0f);
+        }
+        PSParameters.NumSubpixelCells = FMath::Max(NumCells, 1);
+        PSParameters.CellPatternMode = NumCells > 0 ? Lenticular.CellPatternMode : 0;
+        PSParameters.QuiltSampler = TStaticSamplerState<SF_Point>::GetRHI();
+
+        FLookingGlassQuiltCopyPassParameters* PassParameters = GraphBuilder.AllocParameters<FLookingGlassQuiltCopyPassParameters>();
+        PassParameters->SourceTextures.Add(FRDGTextureAccess(Source, ERHIAccess::SRVGraphics));
+        PassParameters->RenderTargets[0] = FRenderTargetBinding(Target, ERenderTargetLoadAction::ENoAction);
+
+        Dump.AddPass(TEXT("Lenticular"), 1);
+
+        GraphBuilder.AddPass(
+            RDG_EVENT_NAME("LookingGlass.Lenticular %dx%d", TargetSize.X, TargetSize.Y),
+            PassParameters,
+            ERDGPassFlags::Raster,
+            [PSParameters, Source, TargetSize](FRHICommandList& RHICmdList) mutable
+            {
+                RHICmdList.SetViewport(0, 0, 0.0f, (float)TargetSize.X, (float)TargetSize.Y, 1.0f);
+
+                auto ShaderMap = GetGlobalShaderMap(GMaxRHIFeatureLevel);
+                TShaderMapRef<FLookingGlassQuiltCopyVS> VertexShader(ShaderMap);
+                TShaderMapRef<FLookingGlassLenticularPS> PixelShader(ShaderMap);
+
+                FGraphicsPipelineStateInitializer GraphicsPSOInit;
+                RHICmdList.ApplyCachedRenderTargets(GraphicsPSOInit);
+                GraphicsPSOInit.BlendState = TStaticBlendState<>::GetRHI();
+                GraphicsPSOInit.RasterizerState = TStaticRasterizerState<>::GetRHI();
+                GraphicsPSOInit.DepthStencilState = TStaticDepthStencilState<false, CF_Always>::GetRHI();
+                GraphicsPSOInit.BoundShaderState.VertexDeclarationRHI = GEmptyVertexDeclaration.VertexDeclarationRHI;
+                GraphicsPSOInit.BoundShaderState.VertexShaderRHI = VertexShader.GetVertexShader();
+                GraphicsPSOInit.BoundShaderState.PixelShaderRHI = PixelShader.GetPixelShader();
+                GraphicsPSOInit.PrimitiveType = PT_TriangleList;
+                SetGraphicsPipelineState(RHICmdList, GraphicsPSOInit, 0);
+
+                // A single quad over the whole panel
+                FLookingGlassQuiltCopyVS::FParameters VSParameters;
+                VSParameters.InvTargetSize = FVector2f(1.0f / TargetSize.X, 1.0f / TargetSize.Y);
+                VSParameters.DestRects[0] = FVector4f(0.0f, 0.0f, TargetSize.X, TargetSize.Y);
+                VSParameters.SourceRects[0] = FVector4f(0.0f, 0.0f, 1.0f, 1.0f);
+
+                PSParameters.QuiltTexture = Source->GetRHI();
+
+                SetShaderParameters(RHICmdList, VertexShader, VertexShader.GetVertexShader(), VSParameters);
+                SetShaderParameters(RHICmdList, PixelShader, PixelShader.GetPixelShader(), PSParameters);
+
+                RHICmdList.DrawPrimitive(0, 2, 1);
+            });
+    }
+
+    // Largest motion of points in front of the focal plane which view synthesis looks for, in view widths. Nearer
+    // points are rare in holograms, and the search range grows with it.
+    static constexpr float MaxSynthesisNearDisparity = 0.25f;
+
+    // Fills quilt tiles of synthesized views, with one draw per view
+    static void AddViewSynthesisPass(FRDGBuilder& GraphBuilder, FRDGTextureRef Target, const FFrameGraphDesc& Desc, const TArray<FRDGTextureRef>& ColorTextures, FFrameGraphDump& Dump)
+    {
+#if WITH_LOOKINGGLASS_VIEW_SYNTHESIS
+        // Depth of every source, it's missing until the source has been rendered once with depth capture
+        TArray<FRDGTextureRef> DepthTextures;
+        for (const FCopyToQuiltBatchSource& Source : Desc.Sources)
+        {
+            const TRefCountPtr<IPooledRenderTarget>* DepthTarget = Source.DepthCapture.IsValid() ? &Source.DepthCapture->GetDepthTarget_RenderThread() : nullptr;
+            FRDGTextureRef DepthTexture = nullptr;
+            if (DepthTarget != nullptr && DepthTarget->IsValid())
+            {
+                DepthTexture = GraphBuilder.RegisterExternalTexture(*DepthTarget, TEXT("LookingGlass.SynthesisDepth"));
+                Dump.AddTexture(DepthTexture, false);
+            }
+            DepthTextures.Add(DepthTexture);
+        }
+
+        FLookingGlassQuiltCopyPassParameters* PassParameters = GraphBuilder.AllocParameters<FLookingGlassQuiltCopyPassParameters>();
+        TArray<FSynthesizedView> Views;
+        for (const FSynthesizedView& View : Desc.Synthesis.Views)
+        {
+            FRDGTextureRef Depth0 = DepthTextures[View.SourceIndex[0]];
+            FRDGTextureRef Depth1 = DepthTextures[View.SourceIndex[1]];
+            if (Depth0 == nullptr || Depth1 == nullptr)
+            {
+                continue;
+            }
+            PassParameters->SourceTextures.AddUnique(FRDGTextureAccess(ColorTextures[View.SourceIndex[0]], ERHIAccess::SRVGraphics));
+            PassParameters->SourceTextures.AddUnique(FRDGTextureAccess(ColorTextures[View.SourceIndex[1]], ERHIAccess::SRVGraphics));
+            PassParameters->SourceTextures.AddUnique(FRDGTextureAccess(Depth0, ERHIAccess::SRVGraphics));
+            PassParameters->SourceTextures.AddUnique(FRDGTextureAccess(Depth1, ERHIAccess::SRVGraphics));
+            Views.Add(View);
+        }
+        if (Views.Num() == 0)
+        {
+            return;
+        }
+        PassParameters->RenderTargets[0] = FRenderTargetBinding(Target, ERenderTargetLoadAction::ELoad);
+
+        Dump.AddPass(TEXT("ViewSynthesis"), Views.Num());
+
+        // Desc is referenced by the pass, it outlives the graph which is executed in ExecuteFrameGraph_RenderThread
+        const FIntPoint TargetSize = Target->Desc.Extent;
+        GraphBuilder.AddPass(
+            RDG_EVENT_NAME("LookingGlass.ViewSynthesis %d views", Views.Num()),
+            PassParameters,
+            ERDGPassFlags::Raster,
+            [Views = MoveTemp(Views), &Desc, ColorTextures, DepthTextures, TargetSize](FRHICommandList& RHICmdList)
+            {
+                RHICmdList.SetViewport(0, 0, 0.0f, (float)TargetSize.X, (float)TargetSize.Y, 1.0f);
+
+                auto ShaderMap = GetGlobalShaderMap(GMaxRHIFeatureLevel);
+                TShaderMapRef<FLookingGlassQuiltCopyVS> VertexShader(ShaderMap);
+                TShaderMapRef<FLookingGlassViewSynthesisPS> PixelShader(ShaderMap);
+
+                FGraphicsPipelineStateInitializer GraphicsPSOInit;
+                RHICmdList.ApplyCachedRenderTargets(GraphicsPSOInit);
+                GraphicsPSOInit.BlendState = TStaticBlendState<>::GetRHI();
+                GraphicsPSOInit.RasterizerState = TStaticRasterizerState<>::GetRHI();
+                GraphicsPSOInit.DepthStencilState = TStaticDepthStencilState<false, CF_Always>::GetRHI();
+                GraphicsPSOInit.BoundShaderState.VertexDeclarationRHI = GEmptyVertexDeclaration.VertexDeclarationRHI;
+                GraphicsPSOInit.BoundShaderState.VertexShaderRHI = VertexShader.GetVertexShader();
+                GraphicsPSOInit.BoundShaderState.PixelShaderRHI = PixelShader.GetPixelShader();
+                GraphicsPSOInit.PrimitiveType = PT_TriangleList;
+                SetGraphicsPipelineState(RHICmdList, GraphicsPSOInit, 0);
+
+                for (const FSynthesizedView& View : Views)
+                {
+                    FIntRect TileRect;
+                    FLookingGlassRenderingConfig::CalculateQuiltTileRect(TileRect, Desc.TilingValues, Desc.QuiltOrder, View.QuiltViewIndex);
+
+                    // The vertex shader passes view UV to the pixel shader
+                    FLookingGlassQuiltCopyVS::FParameters VSParameters;
+                    VSParameters.InvTargetSize = FVector2f(1.0f / TargetSize.X, 1.0f / TargetSize.Y);
+                    VSParameters.DestRects[0] = FVector4f(TileRect.Min.X, TileRect.Min.Y, TileRect.Max.X, TileRect.Max.Y);
+                    VSParameters.SourceRects[0] = FVector4f(0.0f, 0.0f, 1.0f, 1.0f);
+
+                    FLookingGlassViewSynthesisPS::FParameters PSParameters;
+                    FVector4f SourceRects[2];
+                    float MaxNearDisparity[2];
+                    for (int32 Side = 0; Side < 2; ++Side)
+                    {
+                        const FCopyToQuiltBatchSource& Source = Desc.Sources[View.SourceIndex[Side]];
+                        float U = 0.f, V = 0.f, SizeU = 1.f, SizeV = 1.f;
+                        FLookingGlassRenderingConfig::CalculateViewRect(U, V, SizeU, SizeV, Source.ViewRows, Source.ViewColumns, Source.NumViews, View.SourceViewIndex[Side]);
+                        if (Source.ViewScales.IsValidIndex(View.SourceViewIndex[Side]))
+                        {
+                            SizeU *= Source.ViewScales[View.SourceViewIndex[Side]].X;
+                            SizeV *= Source.ViewScales[View.SourceViewIndex[Side]].Y;
+                        }
+                        SourceRects[Side] = FVector4f(U, V, SizeU, SizeV);
+
+                        // Motion of a point at the near plane (device Z = 1), limited by the search range
+                        const float NearDisparity = 0.5f * FMath::Abs(View.ProjectionShift[Side]) * ((1.0f - Desc.Synthesis.DepthBias) * Desc.Synthesis.DepthScale - 1.0f);
+                        MaxNearDisparity[Side] = FMath::Clamp(NearDisparity, 0.0f, MaxSynthesisNearDisparity);
+                    }
+                    PSParameters.SourceRect0 = SourceRects[0];
+                    PSParameters.SourceRect1 = SourceRects[1];
+                    PSParameters.ProjectionShift = FVector2f(View.ProjectionShift[0], View.ProjectionShift[1]);
+                    PSParameters.Weight = View.Weight;
+                    PSParameters.DepthScale = Desc.Synthesis.DepthScale;
+                    PSParameters.DepthBias = Desc.Synthesis.DepthBias;
+                    PSParameters.MaxNearDisparity = FVector2f(MaxNearDisparity[0], MaxNearDisparity[1]);
+                    PSParameters.ColorTexture0 = ColorTextures[View.SourceIndex[0]]->GetRHI();
+                    PSParameters.ColorTexture1 = ColorTextures[View.SourceIndex[1]]->GetRHI();
+                    PSParameters.DepthTexture0 = DepthTextures[View.SourceIndex[0]]->GetRHI();
+                    PSParameters.DepthTexture1 = DepthTextures[View.SourceIndex[1]]->GetRHI();
+                    PSParameters.PointSampler = TStaticSamplerState<SF_Point>::GetRHI();
+                    PSParameters.BilinearSampler = TStaticSamplerState<SF_Bilinear>::GetRHI();
+
+                    SetShaderParameters(RHICmdList, VertexShader, VertexShader.GetVertexShader(), VSParameters);
+                    SetShaderParameters(RHICmdList, PixelShader, PixelShader.GetPixelShader(), PSParameters);
+
+                    RHICmdList.DrawPrimitive(0, 2, 1);
+                }
+            });
+#endif
+    }
+}
+
+void LookingGlass::AddDepthCopyPass(FRDGBuilder& GraphBuilder, FRDGTextureRef SceneDepth, const FIntRect& ViewRect, FRDGTextureRef Target)
+{
+    FQuiltCopyDraw Draw;
+    Draw.Source = SceneDepth;
+    Draw.DestRects.Add(FVector4f(ViewRect.Min.X, ViewRect.Min.Y, ViewRect.Max.X, ViewRect.Max.Y));
+    const FVector2f InvExtent(1.0f / SceneDepth->Desc.Extent.X, 1.0f / SceneDepth->Desc.Extent.Y);
+    Draw.SourceRects.Add(FVector4f(ViewRect.Min.X * InvExtent.X, ViewRect.Min.Y * InvExtent.Y, ViewRect.Width() * InvExtent.X, ViewRect.Height() * InvExtent.Y));
+
+    TArray<FQuiltCopyDraw> Draws;
+    Draws.Add(MoveTemp(Draw));
+
+    FFrameGraphDump Dump;
+    AddQuiltCopyPass(GraphBuilder, RDG_EVENT_NAME("LookingGlass.CaptureDepth"), TEXT("CaptureDepth"), Target, MoveTemp(Draws), false, Dump);
+}
+
+void LookingGlass::ExecuteFrameGraph_RenderThread(FRHICommandListImmediate& RHICmdList, const FFrameGraphDesc& Desc)
+{
+    check(IsInRenderingThread());
+    DISPLAY_HOLOPLAY_FUNC_TRACE(LookingGlassLogRender)
+
+    FRDGBuilder GraphBuilder(RHICmdList, RDG_EVENT_NAME("LookingGlassFrame"));
+
+    FFrameGraphDump Dump;
+    Dump.bEnabled = Desc.bDumpGraph;
+
+    // The image which is presented at the end of the frame
+    FRDGTextureRef Image = nullptr;
+    if (Desc.QuiltTargetResource != nullptr)
+    {
+        Image = RegisterTexture(GraphBuilder, Desc.QuiltTargetResource->GetRenderTargetTexture(), TEXT("LookingGlass.Quilt"), Dump);
+    }
+
+    if (Desc.FullImageSource != nullptr)
+    {
+        // 2D rendering: stretch the picture over the quilt, or present it directly
+        FRDGTextureRef Source = RegisterTexture(GraphBuilder, Desc.FullImageSource->TextureRHI, TEXT("LookingGlass.Image2D"), Dump);
+        if (Image != nullptr)
+        {
+            AddImageCopyPass(GraphBuilder, RDG_EVENT_NAME("LookingGlass.Image2DToQuilt"), TEXT("Image2DToQuilt"), Source, Image, Dump);
+        }
+        else
+        {
+            Image = Source;
+        }
+    }
+    else if (Desc.Sources.Num() > 0 && Image != nullptr)
+    {
+        // Quilt assembly: one instanced draw per tiling texture
+        TArray<FQuiltCopyDraw> Draws;
+        TArray<FRDGTextureRef> SourceTextures;
+        for (const FCopyToQuiltBatchSource& Source : Desc.Sources)
+        {
+            FQuiltCopyDraw& Draw = Draws.AddDefaulted_GetRef();
+            Draw.Source = RegisterTexture(GraphBuilder, Source.TilingTextureResource->TextureRHI, TEXT("LookingGlass.Tiling"), Dump);
+            SourceTextures.Add(Draw.Source);
+
+            for (int32 ViewIndex = 0; ViewIndex < Source.NumViews; ++ViewIndex)
+            {
+                FIntRect TileRect;
+                FLookingGlassRenderingConfig::CalculateQuiltTileRect(TileRect, Desc.TilingValues, Desc.QuiltOrder, Source.QuiltViewIndices[ViewIndex]);
+                Draw.DestRects.Add(FVector4f(TileRect.Min.X, TileRect.Min.Y, TileRect.Max.X, TileRect.Max.Y));
+
+                float U = 0.f, V = 0.f, SizeU = 1.f, SizeV = 1.f;
+                FLookingGlassRenderingConfig::CalculateViewRect(U, V, SizeU, SizeV, Source.ViewRows, Source.ViewColumns, Source.NumViews, ViewIndex);
+                if (Source.ViewScales.IsValidIndex(ViewIndex))
+                {
+                    // The view was rendered at lower resolution, stretch it over the tile
+                    SizeU *= Source.ViewScales[ViewIndex].X;
+                    SizeV *= Source.ViewScales[ViewIndex].Y;
+                }
+                Draw.SourceRects.Add(FVector4f(U, V, SizeU, SizeV));
+            }
+        }
+
+        INC_DWORD_STAT(STAT_QuiltCopyPasses);
+        INC_DWORD_STAT_BY(STAT_QuiltCopyDraws, Draws.Num());
+
+        {
+            // The copy alone, the frame graph as a whole has its own stats
+            SCOPE_CYCLE_COUNTER(STAT_CopyToQuiltBatched_RenderThread);
+            RDG_GPU_STAT_SCOPE(GraphBuilder, CopyToQuiltBatched);
+            AddQuiltCopyPass(GraphBuilder, RDG_EVENT_NAME("LookingGlass.QuiltAssembly %d sources", Draws.Num()), TEXT("QuiltAssembly"), Image, MoveTemp(Draws), true, Dump);
+        }
+
+        if (Desc.Synthesis.Views.Num() > 0)
+        {
+            AddViewSynthesisPass(GraphBuilder, Image, Desc, SourceTextures, Dump);
+        }
+    }
+
+    if (Desc.OutputViewport != nullptr && Image != nullptr)
+    {
+        // Copy the result to the debug window. Can't render things directly there, because of some texture type
+        // incompatibilities - the viewport's RT is not URenderTarget or any other types used here.
+        FRDGTextureRef ViewportTexture = RegisterTexture(GraphBuilder, Desc.OutputViewport->GetRenderTargetTexture(), TEXT("LookingGlass.Viewport"), Dump);
+        if (Desc.Lenticular.bEnabled)
+        {
+            // The window covers the panel: make the native image right after quilt assembly, in the same graph
+            AddLenticularPass(GraphBuilder, Image, ViewportTexture, Desc, Dump);
+        }
+        else
+        {
+            AddImageCopyPass(GraphBuilder, RDG_EVENT_NAME("LookingGlass.CopyToViewport"), TEXT("CopyToViewport"), Image, ViewportTexture, Dump);
+        }
+        GraphBuilder.SetTextureAccessFinal(ViewportTexture, ERHIAccess::SRVMask);
+    }
+
+    if (Desc.Readback.IsValid() && Image != nullptr)
+    {
+        // Convert the image to 8-bit color, and copy it to CPU memory. Data is picked up a few frames later, when GPU is done.
+        FQuiltReadbackSlot& Slot = *Desc.Readback;
+        if (!Slot.Readback.IsValid())
+        {
+            Slot.Readback = MakeUnique<FRHIGPUTextureReadback>(TEXT("LookingGlass.QuiltReadback"));
+        }
+        Slot.Size = Image->Desc.Extent;
+
+        FRDGTextureRef ReadbackTexture = Image;
+        if (Image->Desc.Format != PF_B8G8R8A8)
+        {
+            ReadbackTexture = GraphBuilder.CreateTexture(
+                FRDGTextureDesc::Create2D(Image->Desc.Extent, PF_B8G8R8A8, FClearValueBinding::None, TexCreate_RenderTargetable | TexCreate_ShaderResource),
+                TEXT("LookingGlass.QuiltReadback"));
+            Dump.AddTexture(ReadbackTexture, true);
+
+            AddImageCopyPass(GraphBuilder, RDG_EVENT_NAME("LookingGlass.ConvertForReadback"), TEXT("ConvertForReadback"), Image, ReadbackTexture, Dump);
+        }
+        // else: the image is already in FColor layout, copy it as is
+        AddEnqueueCopyPass(GraphBuilder, Slot.Readback.Get(), ReadbackTexture);
+        Dump.AddPass(TEXT("EnqueueReadback"), 0);
+        Slot.bCopyEnqueued = true;
+    }
+
+    if (Desc.QuiltTargetResource != nullptr && Image != nullptr)
+    {
+        // Hand the quilt over to the Bridge, which samples it as a shader resource
+        GraphBuilder.SetTextureAccessFinal(Image, ERHIAccess::SRVMask);
+    }
+
+    Dump.Log();
+
+    GraphBuilder.Execute();
+}
@@ -3,13 +3,18 @@
 #pragma once
 
 #include "LookingGlassSettings.h"
+#include "Render/LookingGlassReadback.h"
+#include "Render/LookingGlassInterleaver.h"
+#include "LookingGlassBridge.h"
 
 #include "RHI.h"
+#include "RenderGraphDefinitions.h"
 #include "Components/SceneCaptureComponent.h"
 
 class FViewport;
 class FTextureRenderTargetResource;
 class FTextureResource;
+class FLookingGlassDepthCapture;
 
 namespace LookingGlass
 {
@@ -26,6 +31,8 @@ namespace LookingGlass
 		FSceneCaptureViewInfo CaptureViewInfo;
 		// Quilt tile ordering
 		ELookingGlassQuiltOrder QuiltOrder = ELookingGlassQuiltOrder::BottomLeft_To_TopRight;
+		// Rendered part of the view rectangle
+		FVector2f ViewScale = FVector2f(1.0f, 1.0f);
 	};
 
 	/**
@@ -40,4 +47,118 @@ namespace LookingGlass
 	 */
 
 	void CopyToQuiltShader_RenderThread(FRHICommandListImmediate& RHICmdList, const FCopyToQuiltRenderContext& Context);
+
+	// A tiling render target with all its views, used as a source of the batched quilt copy
+	struct FCopyToQuiltBatchSource
+	{
+		const FTextureResource* TilingTextureResource;
+		// Quilt tile of every view
+		TArray<int32> QuiltViewIndices;
+		int32 NumViews;
+		int32 ViewRows;
+		int32 ViewColumns;
+		// Scene depth of the views, when they are used for view synthesis
+		TSharedPtr<FLookingGlassDepthCapture, ESPMode::ThreadSafe> DepthCapture;
+		// Rendered part of every view rectangle, upsampled to the whole tile. Empty when views have full resolution.
+		TArray<FVector2f> ViewScales;
+	};
+
+	// A view which isn't rendered, but synthesized from its nearest rendered neighbours on both sides
+	struct FSynthesizedView
+	{
+		int32 QuiltViewIndex;
+		// Neighbours: index in FFrameGraphDesc::Sources and index of the view in that source
+		int32 SourceIndex[2];
+		int32 SourceViewIndex[2];
+		// Projection offset of this view relative to every neighbour, in clip space units
+		float ProjectionShift[2];
+		// Weight of the second neighbour
+		float Weight;
+	};
+
+	struct FViewSynthesisDesc
+	{
+		TArray<FSynthesizedView> Views;
+		// Converts device Z to FocalDistance / Z: (DeviceZ - DepthBias) * DepthScale
+		float DepthScale = 1.0f;
+		float DepthBias = 0.0f;
+	};
+
+	// Lenticular interleave of the image into the output viewport, which covers the panel
+	struct FLenticularDesc
+	{
+		bool bEnabled = false;
+		FLenticularParams Params;
+		// Number of quilt tiles, 1x1 when the image is shown as a whole, like a 2D picture or the quilt itself
+		FIntPoint Tiles = FIntPoint(1, 1);
+		// Subpixel layout of the panel, a plain RGB stripe when empty
+		TArray<FLGSubpixelCell> SubpixelCells;
+		int32 CellPatternMode = 0;
+	};
+
+	/**
+	 * Post-capture work of a single frame. It is filled on the game thread and executed on the rendering
+	 * thread as one render graph: quilt assembly, copy of the result to the debug viewport (or its lenticular
+	 * interleave for the panel), and hand-off of the quilt to the Bridge.
+	 */
+	struct FFrameGraphDesc
+	{
+		// Quilt texture, the result of the graph which is passed to the Bridge. Could be null when a 2D image
+		// is presented in the debug window.
+		const FTextureRenderTargetResource* QuiltTargetResource = nullptr;
+
+		// Quilt assembly: all views are copied to their tiles with a single render pass. Nothing is copied
+		// when Sources is empty, e.g. when the views were rendered directly into the quilt.
+		FLookingGlassTilingQuality TilingValues;
+		ELookingGlassQuiltOrder QuiltOrder = ELookingGlassQuiltOrder::BottomLeft_To_TopRight;
+		TArray<FCopyToQuiltBatchSource> Sources;
+
+		// Views which are synthesized from Sources after quilt assembly
+		FViewSynthesisDesc Synthesis;
+
+		// A single image stretched over the whole quilt, used for 2D rendering. Replaces quilt assembly.
+		const FTextureResource* FullImageSource = nullptr;
+
+		// Viewport which receives a copy of the result, when not rendering on device
+		FViewport* OutputViewport = nullptr;
+
+		// Interleave the result into OutputViewport instead of copying it, when the viewport is on the panel and
+		// the frame is presented without Bridge
+		FLenticularDesc Lenticular;
+
+		// Asynchronous readback of the resulting image, for screenshots and movie capture
+		FQuiltReadbackSlotPtr Readback;
+
+		// Log passes and texture memory of this graph
+		bool bDumpGraph = false;
+
+		bool HasWork() const
+		{
+			return Sources.Num() > 0 || FullImageSource != nullptr || OutputViewport != nullptr || Readback.IsValid();
+		}
+	};
+
+	/**
+	 * @fn	void ExecuteFrameGraph_RenderThread(FRHICommandListImmediate& RHICmdList, const FFrameGraphDesc& Desc);
+	 *
+	 * @brief	Builds and executes the render graph of post-capture work
+	 *
+	 * @param [in,out]	RHICmdList 	List of rhi commands.
+	 * @param 		  	Desc	   	Description of the frame.
+	 */
+
+	void ExecuteFrameGraph_RenderThread(FRHICommandListImmediate& RHICmdList, const FFrameGraphDesc& Desc);
+
+	/**
+	 * @fn	void AddDepthCopyPass(FRDGBuilder& GraphBuilder, FRDGTextureRef SceneDepth, const FIntRect& ViewRect, FRDGTextureRef Target);
+	 *
+	 * @brief	Copies device Z of a view from scene depth into the same rectangle of Target
+	 *
+	 * @param [in,out]	GraphBuilder	The render graph.
+	 * @param 		  	SceneDepth  	Scene depth texture of the view family.
+	 * @param 		  	ViewRect		Rectangle of the view.
+	 * @param 		  	Target			Color texture which receives the depth.
+	 */
+
+	void AddDepthCopyPass(FRDGBuilder& GraphBuilder, FRDGTextureRef SceneDepth, const FIntRect& ViewRect, FRDGTextureRef Target);
 }
@@ -2,6 +2,7 @@
 
 #include "Game/LookingGlassSceneCaptureComponent2D.h"
 #include "Game/LookingGlassCapture.h"
+#include "Render/LookingGlassViewSynthesis.h"
 
 #include "Engine/Engine.h"
 #include "EngineModule.h" // for GetRendererModule()
@@ -19,6 +20,86 @@
 
 #include "Runtime/Launch/Resources/Version.h"
 
+static FPrimitiveComponentId GetPrimitiveId(const UPrimitiveComponent* PrimitiveComponent)
+{
+#if ENGINE_MAJOR_VERSION < 5 || ENGINE_MINOR_VERSION >= 4
+	return PrimitiveComponent->GetPrimitiveSceneId();
+#else
+	return PrimitiveComponent->ComponentId;
+#endif
+}
+
+static void AddActorPrimitives(const AActor* Actor, TSet<FPrimitiveComponentId>& OutPrimitives)
+{
+	for (UActorComponent* Component : Actor->GetComponents())
+	{
+		if (UPrimitiveComponent* PrimComp = Cast<UPrimitiveComponent>(Component))
+		{
+			OutPrimitives.Add(GetPrimitiveId(PrimComp));
+		}
+	}
+}
+
+// Since 5.4 the following code originated from GetShowOnlyAndHiddenComponents() from SceneCaptureRendering.cpp
+static void GetShowOnlyAndHiddenComponents(USceneCaptureComponent* SceneCaptureComponent, TSet<FPrimitiveComponentId>& HiddenPrimitives, TOptional<TSet<FPrimitiveComponentId>>& ShowOnlyPrimitives)
+{
+	check(SceneCaptureComponent);
+	for (auto It = SceneCaptureComponent->HiddenComponents.CreateConstIterator(); It; ++It)
+	{
+		// If the primitive component was destroyed, the weak pointer will return NULL.
+		UPrimitiveComponent* PrimitiveComponent = It->Get();
+		if (PrimitiveComponent)
+		{
+			HiddenPrimitives.Add(GetPrimitiveId(PrimitiveComponent));
+		}
+	}
+
+	for (auto It = SceneCaptureComponent->HiddenActors.CreateConstIterator(); It; ++It)
+	{
+		AActor* Actor = *It;
+
+		if (Actor)
+		{
+			AddActorPrimitives(Actor, HiddenPrimitives);
+		}
+	}
+
+	if (SceneCaptureComponent->PrimitiveRenderMode == ESceneCapturePrimitiveRenderMode::PRM_UseShowOnlyList)
+	{
+		ShowOnlyPrimitives.Emplace();
+
+		for (auto It = SceneCaptureComponent->ShowOnlyComponents.CreateConstIterator(); It; ++It)
+		{
+			// If the primitive component was destroyed, the weak pointer will return NULL.
+			UPrimitiveComponent* PrimitiveComponent = It->Get();
+			if (PrimitiveComponent)
+			{
+				ShowOnlyPrimitives->Add(GetPrimitiveId(PrimitiveComponent));
+			}
+		}
+
+		for (auto It = SceneCaptureComponent->ShowOnlyActors.CreateConstIterator(); It; ++It)
+		{
+			AActor* Actor = *It;
+
+			if (Actor)
+			{
+				AddActorPrimitives(Actor, ShowOnlyPrimitives.GetValue());
+			}
+		}
+	}
+	else if (SceneCaptureComponent->ShowOnlyComponents.Num() > 0 || SceneCaptureComponent->ShowOnlyActors.Num() > 0)
+	{
+		static bool bWarned = false;
+
+		if (!bWarned)
+		{
+			UE_LOG(LogTemp, Log, TEXT("Scene Capture has ShowOnlyComponents or ShowOnlyActors ignored by the PrimitiveRenderMode setting! %s"), *SceneCaptureComponent->GetPathName());
+			bWarned = true;
+		}
+	}
+}
+
 // This function is heavily based on SetupViewFamilyForSceneCapture() from SceneCaptureRendering.cpp
 static void SetupViewVamilyForSceneCapture(
 	FSceneViewFamily& ViewFamily,
@@ -29,10 +110,19 @@ static void SetupViewVamilyForSceneCapture(
 	bool bIsPlanarReflection,
 	FPostProcessSettings* PostProcessSettings,
 	float PostProcessBlendWeight,
-	const AActor* ViewActor)
+	const AActor* ViewActor,
+	bool bShareViewSetup)
 {
 	check(!ViewFamily.GetScreenPercentageInterface());
 
+	// Hidden and show-only primitives are the same for all views, collect them once
+	TSet<FPrimitiveComponentId> HiddenPrimitives;
+	TOptional<TSet<FPrimitiveComponentId>> ShowOnlyPrimitives;
+	GetShowOnlyAndHiddenComponents(SceneCaptureComponent, HiddenPrimitives, ShowOnlyPrimitives);
+
+	// Volume blended post process settings of the first view, when they're shared
+	TUniquePtr<FFinalPostProcessSettings> SharedPostProcessSettings;
+
 	// Ensure that the views for this scene capture reflect any simulated camera motion for this frame
 	TOptional<FTransform> PreviousTransform = FMotionVectorSimulation::Get().GetPreviousTransform(SceneCaptureComponent);
 	FPlane ClipPlane = FPlane(SceneCaptureComponent->ClipPlaneBase, SceneCaptureComponent->ClipPlaneNormal.GetSafeNormal());
@@ -94,94 +184,28 @@ static void SetupViewVamilyForSceneCapture(
 			}
 		}
 
-		// Since 5.4 the following code originated from GetShowOnlyAndHiddenComponents()
-		check(SceneCaptureComponent);
-		for (auto It = SceneCaptureComponent->HiddenComponents.CreateConstIterator(); It; ++It)
-		{
-			// If the primitive component was destroyed, the weak pointer will return NULL.
-			UPrimitiveComponent* PrimitiveComponent = It->Get();
-			if (PrimitiveComponent)
-			{
-#if ENGINE_MAJOR_VERSION < 5 || ENGINE_MINOR_VERSION >= 4
-				View->HiddenPrimitives.Add(PrimitiveComponent->GetPrimitiveSceneId());
-#else
-				View->HiddenPrimitives.Add(PrimitiveComponent->ComponentId);
-#endif
-			}
-		}
-
-		for (auto It = SceneCaptureComponent->HiddenActors.CreateConstIterator(); It; ++It)
-		{
-			AActor* Actor = *It;
+		View->HiddenPrimitives = HiddenPrimitives;
+		View->ShowOnlyPrimitives = ShowOnlyPrimitives;
 
-			if (Actor)
-			{
-				for (UActorComponent* Component : Actor->GetComponents())
-				{
-					if (UPrimitiveComponent* PrimComp = Cast<UPrimitiveComponent>(Component))
-					{
-#if ENGINE_MAJOR_VERSION < 5 || ENGINE_MINOR_VERSION >= 4
-						View->HiddenPrimitives.Add(PrimComp->GetPrimitiveSceneId());
-#else
-						View->HiddenPrimitives.Add(PrimComp->ComponentId);
-#endif
-					}
-				}
-			}
-		}
+		ViewFamily.Views.Add(View);
 
-		if (SceneCaptureComponent->PrimitiveRenderMode == ESceneCapturePrimitiveRenderMode::PRM_UseShowOnlyList)
+		if (SharedPostProcessSettings.IsValid())
 		{
-			View->ShowOnlyPrimitives.Emplace();
-
-			for (auto It = SceneCaptureComponent->ShowOnlyComponents.CreateConstIterator(); It; ++It)
+			// Views are only slightly apart, reuse post process volumes blended for the first view
+			View->FinalPostProcessSettings = *SharedPostProcessSettings;
+			if (View->State != nullptr)
 			{
-				// If the primitive component was destroyed, the weak pointer will return NULL.
-				UPrimitiveComponent* PrimitiveComponent = It->Get();
-				if (PrimitiveComponent)
-				{
-#if ENGINE_MAJOR_VERSION < 5 || ENGINE_MINOR_VERSION >= 4
-					View->HiddenPrimitives.Add(PrimitiveComponent->GetPrimitiveSceneId());
-#else
-					View->HiddenPrimitives.Add(PrimitiveComponent->ComponentId);
-#endif
-				}
-			}
-
-			for (auto It = SceneCaptureComponent->ShowOnlyActors.CreateConstIterator(); It; ++It)
-			{
-				AActor* Actor = *It;
-
-				if (Actor)
-				{
-					for (UActorComponent* Component : Actor->GetComponents())
-					{
-						if (UPrimitiveComponent* PrimComp = Cast<UPrimitiveComponent>(Component))
-						{
-#if ENGINE_MAJOR_VERSION < 5 || ENGINE_MINOR_VERSION >= 4
-							View->HiddenPrimitives.Add(PrimComp->GetPrimitiveSceneId());
-#else
-							View->HiddenPrimitives.Add(PrimComp->ComponentId);
-#endif
-						}
-					}
-				}
+				View->State->OnStartPostProcessing(*View);
 			}
 		}
-		else if (SceneCaptureComponent->ShowOnlyComponents.Num() > 0 || SceneCaptureComponent->ShowOnlyActors.Num() > 0)
+		else
 		{
-			static bool bWarned = false;
-
-			if (!bWarned)
+			View->StartFinalPostprocessSettings(SceneCaptureViewInfo.ViewLocation);
+			if (bShareViewSetup)
 			{
-				UE_LOG(LogTemp, Log, TEXT("Scene Capture has ShowOnlyComponents or ShowOnlyActors ignored by the PrimitiveRenderMode setting! %s"), *SceneCaptureComponent->GetPathName());
-				bWarned = true;
+				SharedPostProcessSettings = MakeUnique<FFinalPostProcessSettings>(View->FinalPostProcessSettings);
 			}
 		}
-
-		ViewFamily.Views.Add(View);
-
-		View->StartFinalPostprocessSettings(SceneCaptureViewInfo.ViewLocation);
 		View->OverridePostProcessSettings(*PostProcessSettings, PostProcessBlendWeight);
 		View->EndFinalPostprocessSettings(ViewInitOptions);
 	}
@@ -196,7 +220,8 @@ static void CreateSceneRendererForSceneCapture(
 	FPostProcessSettings* PostProcessSettings,
 	float PostProcessBlendWeight,
 	const AActor* ViewActor,
-	FLookingGlassRenderingConfig& RenderingConfig
+	FLookingGlassRenderingConfig& RenderingConfig,
+	bool bShareViewSetup
 )
 {
 	FSceneViewFamilyContext ViewFamily(FSceneViewFamily::ConstructionValues(
@@ -216,7 +241,8 @@ static void CreateSceneRendererForSceneCapture(
 		/* bIsPlanarReflection = */ false,
 		PostProcessSettings,
 		PostProcessBlendWeight,
-		ViewActor);
+		ViewActor,
+		bShareViewSetup);
 
 	// Screen percentage is still not supported in scene capture.
 	ViewFamily.EngineShowFlags.ScreenPercentage = false;
@@ -229,6 +255,14 @@ static void CreateSceneRendererForSceneCapture(
 	// Reset scene capture's camera cut.
 	SceneCaptureComponent->bCameraCutThisFrame = false;
 
+#if WITH_LOOKINGGLASS_VIEW_SYNTHESIS
+	// Keep depth of the views for synthesis of views which aren't rendered
+	if (RenderingConfig.GetDepthCapture().IsValid())
+	{
+		ViewFamily.ViewExtensions.Add(RenderingConfig.GetDepthCapture().ToSharedRef());
+	}
+#endif
+
 	auto FeatureLevel = ViewFamily.GetFeatureLevel();
 
 	if (UTextureRenderTarget2D* TextureRenderTarget = SceneCaptureComponent->TextureTarget)
@@ -248,10 +282,16 @@ static void CreateSceneRendererForSceneCapture(
 #if (ENGINE_MAJOR_VERSION == 4) && (ENGINE_MINOR_VERSION < 26)
 				FGenerateMips::Execute(RHICmdList, TextureRenderTargetResource->GetRenderTargetTexture(), GenerateMipsParams);
 #else
-				// Just embedded the older version of FGenerateMips::Execute, which became deprecated in 4.26 and removed in 5.1
+				// The RHICmdList version of FGenerateMips::Execute became deprecated in 4.26 and removed in 5.1, use render graph
 				TRefCountPtr<IPooledRenderTarget> PooledRenderTarget = CreateRenderTarget(TextureRenderTargetResource->GetRenderTargetTexture(), TEXT("MipGeneration"));
-				FRDGBuilder GraphBuilder(RHICmdList);
-				//FGenerateMips::Execute(GraphBuilder, GraphBuilder.RegisterExternalTexture(PooledRenderTarget), GenerateMipsParams);
+				FRDGBuilder GraphBuilder(RHICmdList, RDG_EVENT_NAME("LookingGlassGenerateMips"));
+				FRDGTextureRef MipsTexture = GraphBuilder.RegisterExternalTexture(PooledRenderTarget);
+#if (ENGINE_MAJOR_VERSION == 5) && (ENGINE_MINOR_VERSION >= 1)
+				FGenerateMips::Execute(GraphBuilder, FeatureLevel, MipsTexture, GenerateMipsParams);
+#else
+				FGenerateMips::Execute(GraphBuilder, MipsTexture, GenerateMipsParams);
+#endif
+				GraphBuilder.SetTextureAccessFinal(MipsTexture, ERHIAccess::SRVMask);
 				GraphBuilder.Execute();
 #endif
 			}
@@ -273,6 +313,7 @@ void ULookingGlassSceneCaptureComponent2D::UpdateLookingGlassSceneCaptureContent
 	{
 		const bool bUseSceneColorTexture = CaptureComponent->CaptureSource != SCS_FinalColorLDR &&
 			CaptureComponent->CaptureSource != SCS_FinalColorHDR;
+		const ULookingGlassSceneCaptureComponent2D* LookingGlassCaptureComponent = Cast<ULookingGlassSceneCaptureComponent2D>(CaptureComponent);
 
 		CreateSceneRendererForSceneCapture(
 			Scene,
@@ -283,7 +324,8 @@ void ULookingGlassSceneCaptureComponent2D::UpdateLookingGlassSceneCaptureContent
 			&CaptureComponent->PostProcessSettings,
 			CaptureComponent->PostProcessBlendWeight,
 			CaptureComponent->GetViewOwner(),
-			RenderingConfig
+			RenderingConfig,
+			LookingGlassCaptureComponent != nullptr && LookingGlassCaptureComponent->bShareViewSetup
 		);
 	}
 }
\ No newline at end of file
@@ -0,0 +1,6 @@
+#include "Render/LookingGlassShaders.h"
+
+IMPLEMENT_GLOBAL_SHADER(FLookingGlassQuiltCopyVS, "/Plugin/LookingGlass/Private/LookingGlassQuiltCopy.usf", "MainVS", SF_Vertex);
+IMPLEMENT_GLOBAL_SHADER(FLookingGlassQuiltCopyPS, "/Plugin/LookingGlass/Private/LookingGlassQuiltCopy.usf", "MainPS", SF_Pixel);
+IMPLEMENT_GLOBAL_SHADER(FLookingGlassViewSynthesisPS, "/Plugin/LookingGlass/Private/LookingGlassViewSynthesis.usf", "MainPS", SF_Pixel);
+IMPLEMENT_GLOBAL_SHADER(FLookingGlassLenticularPS, "/Plugin/LookingGlass/Private/LookingGlassLenticular.usf", "MainPS", SF_Pixel);
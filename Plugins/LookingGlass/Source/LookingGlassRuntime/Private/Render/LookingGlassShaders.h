@@ -0,0 +1,120 @@
+#pragma once
+
+#include "GlobalShader.h"
+#include "ShaderParameterStruct.h"
+#include "RenderGraphResources.h"
+
+#include "Game/LookingGlassSceneCaptureComponent2D.h"
+
+/**
+ * Vertex shader of the batched quilt copy. Every instance places one view of a tiling
+ * render target at its quilt tile.
+ */
+class FLookingGlassQuiltCopyVS : public FGlobalShader
+{
+public:
+	DECLARE_GLOBAL_SHADER(FLookingGlassQuiltCopyVS);
+	SHADER_USE_PARAMETER_STRUCT(FLookingGlassQuiltCopyVS, FGlobalShader);
+
+	BEGIN_SHADER_PARAMETER_STRUCT(FParameters, )
+		SHADER_PARAMETER_ARRAY(FVector4f, DestRects, [FLookingGlassRenderingConfig::MaxView])
+		SHADER_PARAMETER_ARRAY(FVector4f, SourceRects, [FLookingGlassRenderingConfig::MaxView])
+		SHADER_PARAMETER(FVector2f, InvTargetSize)
+	END_SHADER_PARAMETER_STRUCT()
+
+	static void ModifyCompilationEnvironment(const FGlobalShaderPermutationParameters& Parameters, FShaderCompilerEnvironment& OutEnvironment)
+	{
+		FGlobalShader::ModifyCompilationEnvironment(Parameters, OutEnvironment);
+		OutEnvironment.SetDefine(TEXT("MAX_QUILT_COPY_VIEWS"), FLookingGlassRenderingConfig::MaxView);
+	}
+};
+
+/** Pixel shader of the batched quilt copy */
+class FLookingGlassQuiltCopyPS : public FGlobalShader
+{
+public:
+	DECLARE_GLOBAL_SHADER(FLookingGlassQuiltCopyPS);
+	SHADER_USE_PARAMETER_STRUCT(FLookingGlassQuiltCopyPS, FGlobalShader);
+
+	BEGIN_SHADER_PARAMETER_STRUCT(FParameters, )
+		SHADER_PARAMETER_TEXTURE(Texture2D, SourceTexture)
+		SHADER_PARAMETER_SAMPLER(SamplerState, SourceSampler)
+	END_SHADER_PARAMETER_STRUCT()
+
+	static void ModifyCompilationEnvironment(const FGlobalShaderPermutationParameters& Parameters, FShaderCompilerEnvironment& OutEnvironment)
+	{
+		FGlobalShader::ModifyCompilationEnvironment(Parameters, OutEnvironment);
+		OutEnvironment.SetDefine(TEXT("MAX_QUILT_COPY_VIEWS"), FLookingGlassRenderingConfig::MaxView);
+	}
+};
+
+/**
+ * Pixel shader of view synthesis, which fills a quilt tile from color and depth of the nearest rendered views.
+ * Drawn with FLookingGlassQuiltCopyVS, with the whole view as the source rectangle.
+ */
+class FLookingGlassViewSynthesisPS : public FGlobalShader
+{
+public:
+	DECLARE_GLOBAL_SHADER(FLookingGlassViewSynthesisPS);
+	SHADER_USE_PARAMETER_STRUCT(FLookingGlassViewSynthesisPS, FGlobalShader);
+
+	BEGIN_SHADER_PARAMETER_STRUCT(FParameters, )
+		SHADER_PARAMETER(FVector4f, SourceRect0)
+		SHADER_PARAMETER(FVector4f, SourceRect1)
+		SHADER_PARAMETER(FVector2f, ProjectionShift)
+		SHADER_PARAMETER(float, Weight)
+		SHADER_PARAMETER(float, DepthScale)
+		SHADER_PARAMETER(float, DepthBias)
+		SHADER_PARAMETER(FVector2f, MaxNearDisparity)
+		SHADER_PARAMETER_TEXTURE(Texture2D, ColorTexture0)
+		SHADER_PARAMETER_TEXTURE(Texture2D, DepthTexture0)
+		SHADER_PARAMETER_TEXTURE(Texture2D, ColorTexture1)
+		SHADER_PARAMETER_TEXTURE(Texture2D, DepthTexture1)
+		SHADER_PARAMETER_SAMPLER(SamplerState, PointSampler)
+		SHADER_PARAMETER_SAMPLER(SamplerState, BilinearSampler)
+	END_SHADER_PARAMETER_STRUCT()
+};
+
+/**
+ * Pixel shader of the lenticular interleave, which makes the native panel image from the quilt. Drawn with
+ * FLookingGlassQuiltCopyVS over the whole panel.
+ */
+class FLookingGlassLenticularPS : public FGlobalShader
+{
+public:
+	DECLARE_GLOBAL_SHADER(FLookingGlassLenticularPS);
+	SHADER_USE_PARAMETER_STRUCT(FLookingGlassLenticularPS, FGlobalShader);
+
+	// Subpixel cells beyond this number are ignored
+	static constexpr int32 MaxSubpixelCells = 8;
+
+	BEGIN_SHADER_PARAMETER_STRUCT(FParameters, )
+		SHADER_PARAMETER(float, PhaseU)
+		SHADER_PARAMETER(float, PhaseV)
+		SHADER_PARAMETER(float, PhaseBias)
+		SHADER_PARAMETER(float, NumViews)
+		SHADER_PARAMETER(uint32, bInvertViews)
+		SHADER_PARAMETER(FVector2f, ScreenSize)
+		SHADER_PARAMETER(FUintVector2, Tiles)
+		SHADER_PARAMETER(FVector2f, TileSize)
+		SHADER_PARAMETER(FVector2f, TileOffset)
+		SHADER_PARAMETER(FUintVector2, FlipTiles)
+		SHADER_PARAMETER_ARRAY(FVector4f, SubpixelCells, [MaxSubpixelCells * 2])
+		SHADER_PARAMETER(uint32, NumSubpixelCells)
+		SHADER_PARAMETER(uint32, CellPatternMode)
+		SHADER_PARAMETER_TEXTURE(Texture2D, QuiltTexture)
+		SHADER_PARAMETER_SAMPLER(SamplerState, QuiltSampler)
+	END_SHADER_PARAMETER_STRUCT()
+
+	static void ModifyCompilationEnvironment(const FGlobalShaderPermutationParameters& Parameters, FShaderCompilerEnvironment& OutEnvironment)
+	{
+		FGlobalShader::ModifyCompilationEnvironment(Parameters, OutEnvironment);
+		OutEnvironment.SetDefine(TEXT("MAX_SUBPIXEL_CELLS"), MaxSubpixelCells);
+	}
+};
+
+/** Parameters of a render graph pass which copies views (or whole images) with the quilt copy shaders */
+BEGIN_SHADER_PARAMETER_STRUCT(FLookingGlassQuiltCopyPassParameters, )
+	RDG_TEXTURE_ACCESS_ARRAY(SourceTextures)
+	RENDER_TARGET_BINDING_SLOTS()
+END_SHADER_PARAMETER_STRUCT()
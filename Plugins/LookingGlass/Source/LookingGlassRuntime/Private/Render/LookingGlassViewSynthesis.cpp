@@ -0,0 +1,98 @@
+#include "Render/LookingGlassViewSynthesis.h"
+#include "Render/LookingGlassRendering.h"
+#include "Game/LookingGlassSceneCaptureComponent2D.h"
+#include "Misc/LookingGlassStats.h"
+
+#include "RenderGraphBuilder.h"
+#include "SceneView.h"
+#include "UnrealClient.h"
+
+#if WITH_LOOKINGGLASS_VIEW_SYNTHESIS
+
+void FLookingGlassDepthCapture::PostRenderBasePassDeferred_RenderThread(FRDGBuilder& GraphBuilder, FSceneView& InView, const FRenderTargetBindingSlots& RenderTargets, TRDGUniformBufferRef<FSceneTextureUniformParameters> SceneTextures)
+{
+	FRDGTextureRef SceneDepth = RenderTargets.DepthStencil.GetTexture();
+	if (SceneDepth == nullptr || InView.Family->RenderTarget == nullptr)
+	{
+		return;
+	}
+
+	// Depth has the layout of the tiling render target, which is the render target of the view family
+	const FIntPoint Size = InView.Family->RenderTarget->GetSizeXY();
+
+	FRDGTextureRef Target = nullptr;
+	if (DepthTarget.IsValid() && DepthTarget->GetDesc().Extent == Size)
+	{
+		// Registered once per graph, for all views of the family
+		Target = GraphBuilder.RegisterExternalTexture(DepthTarget, TEXT("LookingGlass.SynthesisDepth"));
+	}
+	else
+	{
+		Target = GraphBuilder.CreateTexture(
+			FRDGTextureDesc::Create2D(Size, PF_R32_FLOAT, FClearValueBinding::Black, TexCreate_RenderTargetable | TexCreate_ShaderResource),
+			TEXT("LookingGlass.SynthesisDepth"));
+		DepthTarget = GraphBuilder.ConvertToExternalTexture(Target);
+	}
+
+	LookingGlass::AddDepthCopyPass(GraphBuilder, SceneDepth, InView.UnscaledViewRect, Target);
+}
+
+#endif // WITH_LOOKINGGLASS_VIEW_SYNTHESIS
+
+void LookingGlass::SetupViewSynthesis(const ULookingGlassSceneCaptureComponent2D* CaptureComponent, FFrameGraphDesc& GraphDesc)
+{
+	const FLookingGlassRenderingConfigs& RenderingConfigs = CaptureComponent->GetRenderingConfigs();
+	if (!RenderingConfigs.IsUsingViewSynthesis() || GraphDesc.Sources.Num() != RenderingConfigs.Configs.Num())
+	{
+		return;
+	}
+
+	// Source and view index of every rendered view, in quilt order
+	struct FRenderedView
+	{
+		int32 QuiltViewIndex;
+		int32 SourceIndex;
+		int32 SourceViewIndex;
+	};
+	TArray<FRenderedView> RenderedViews;
+	for (int32 SourceIndex = 0; SourceIndex < GraphDesc.Sources.Num(); ++SourceIndex)
+	{
+		const TArray<int32>& QuiltViewIndices = GraphDesc.Sources[SourceIndex].QuiltViewIndices;
+		for (int32 ViewIndex = 0; ViewIndex < QuiltViewIndices.Num(); ++ViewIndex)
+		{
+			RenderedViews.Add({ QuiltViewIndices[ViewIndex], SourceIndex, ViewIndex });
+		}
+	}
+
+	// Device Z of the capture projection is MaxZ + MinZ / Z, see GenerateProjectionMatrix()
+	const FMatrix ProjectionMatrix = CaptureComponent->GenerateProjectionMatrix(0.0f, 0.0f);
+	const float MaxZ = ProjectionMatrix.M[2][2];
+	const float MinZ = ProjectionMatrix.M[3][2];
+	GraphDesc.Synthesis.DepthScale = CaptureComponent->GetCameraDistance() / FMath::Max(MinZ, KINDA_SMALL_NUMBER);
+	GraphDesc.Synthesis.DepthBias = MaxZ;
+
+	for (int32 Index = 0; Index + 1 < RenderedViews.Num(); ++Index)
+	{
+		const FRenderedView& Left = RenderedViews[Index];
+		const FRenderedView& Right = RenderedViews[Index + 1];
+		const float LeftOffset = CaptureComponent->GetViewProjectionOffset(Left.QuiltViewIndex);
+		const float RightOffset = CaptureComponent->GetViewProjectionOffset(Right.QuiltViewIndex);
+
+		for (int32 QuiltViewIndex = Left.QuiltViewIndex + 1; QuiltViewIndex < Right.QuiltViewIndex; ++QuiltViewIndex)
+		{
+			const float Offset = CaptureComponent->GetViewProjectionOffset(QuiltViewIndex);
+
+			FSynthesizedView& View = GraphDesc.Synthesis.Views.AddDefaulted_GetRef();
+			View.QuiltViewIndex = QuiltViewIndex;
+			View.SourceIndex[0] = Left.SourceIndex;
+			View.SourceIndex[1] = Right.SourceIndex;
+			View.SourceViewIndex[0] = Left.SourceViewIndex;
+			View.SourceViewIndex[1] = Right.SourceViewIndex;
+			View.ProjectionShift[0] = Offset - LeftOffset;
+			View.ProjectionShift[1] = Offset - RightOffset;
+			View.Weight = float(QuiltViewIndex - Left.QuiltViewIndex) / float(Right.QuiltViewIndex - Left.QuiltViewIndex);
+		}
+	}
+
+	INC_DWORD_STAT_BY(STAT_SynthesizedViews, GraphDesc.Synthesis.Views.Num());
+}
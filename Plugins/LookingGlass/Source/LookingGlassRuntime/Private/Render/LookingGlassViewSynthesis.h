@@ -0,0 +1,70 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Runtime/Launch/Resources/Version.h"
+
+// Scene depth is taken from the renderer after the base pass, view extensions can do that since 5.1
+#define WITH_LOOKINGGLASS_VIEW_SYNTHESIS (ENGINE_MAJOR_VERSION > 5 || (ENGINE_MAJOR_VERSION == 5 && ENGINE_MINOR_VERSION >= 1))
+
+#if WITH_LOOKINGGLASS_VIEW_SYNTHESIS
+
+#include "SceneViewExtension.h"
+#include "RenderGraphResources.h"
+
+/**
+ * @class	FLookingGlassDepthCapture
+ *
+ * @brief	Copies scene depth of every view of a tiling render target into a texture with the same layout, which is
+ * 			used for view synthesis. It is added explicitly to view families of a single rendering config, and is
+ * 			never gathered for other views.
+ */
+
+class FLookingGlassDepthCapture : public FSceneViewExtensionBase
+{
+public:
+	FLookingGlassDepthCapture(const FAutoRegister& AutoRegister)
+		: FSceneViewExtensionBase(AutoRegister)
+	{}
+
+	// ISceneViewExtension interface
+	virtual void SetupViewFamily(FSceneViewFamily& InViewFamily) override {}
+	virtual void SetupView(FSceneViewFamily& InViewFamily, FSceneView& InView) override {}
+	virtual void BeginRenderViewFamily(FSceneViewFamily& InViewFamily) override {}
+	virtual void PostRenderBasePassDeferred_RenderThread(FRDGBuilder& GraphBuilder, FSceneView& InView, const FRenderTargetBindingSlots& RenderTargets, TRDGUniformBufferRef<FSceneTextureUniformParameters> SceneTextures) override;
+
+	// Device Z of recently rendered views. Should be accessed on rendering thread only.
+	const TRefCountPtr<IPooledRenderTarget>& GetDepthTarget_RenderThread() const
+	{
+		return DepthTarget;
+	}
+
+protected:
+	virtual bool IsActiveThisFrame_Internal(const FSceneViewExtensionContext& Context) const override
+	{
+		return false;
+	}
+
+private:
+	TRefCountPtr<IPooledRenderTarget> DepthTarget;
+};
+
+#endif // WITH_LOOKINGGLASS_VIEW_SYNTHESIS
+
+class ULookingGlassSceneCaptureComponent2D;
+
+namespace LookingGlass
+{
+	struct FFrameGraphDesc;
+
+	/**
+	 * @fn	void SetupViewSynthesis(const ULookingGlassSceneCaptureComponent2D* CaptureComponent, FFrameGraphDesc& GraphDesc);
+	 *
+	 * @brief	Adds every view which isn't rendered to the frame graph, with its nearest rendered neighbours. Should be
+	 * 			called after GraphDesc.Sources are filled in the order of the component's rendering configs.
+	 *
+	 * @param 		  	CaptureComponent	The capture component.
+	 * @param [in,out]	GraphDesc			The frame graph.
+	 */
+
+	void SetupViewSynthesis(const ULookingGlassSceneCaptureComponent2D* CaptureComponent, FFrameGraphDesc& GraphDesc);
+}
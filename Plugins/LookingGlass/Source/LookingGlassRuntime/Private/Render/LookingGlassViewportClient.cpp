@@ -2,10 +2,14 @@
 #include "Runtime/Launch/Resources/Version.h" // ensure proper version defines
 
 #include "Render/LookingGlassRendering.h"
+#include "Render/LookingGlassViewSynthesis.h"
+#include "Render/LookingGlassReadback.h"
+#include "Render/LookingGlassRenderTargetPool.h"
 #include "Game/LookingGlassCapture.h"
 #include "Misc/LookingGlassLog.h"
 #include "Misc/LookingGlassStats.h"
 #include "Misc/LookingGlassHelpers.h"
+#include "Misc/LookingGlassImageEncoder.h"
 #include "ILookingGlassRuntime.h"
 #include "Game/LookingGlassSceneCaptureComponent2D.h"
 
@@ -16,6 +20,7 @@
 #include "ImageUtils.h"
 
 #include "Misc/FileHelper.h"
+#include "Async/Async.h"
 #include "GameFramework/PlayerController.h"
 #if ENGINE_MAJOR_VERSION >= 5 && ENGINE_MINOR_VERSION >= 1
 #include "GameFramework/PlayerInput.h"
@@ -48,11 +53,22 @@
 
 
 DECLARE_GPU_STAT_NAMED(CopyToQuilt, TEXT("Copy to quilt"));
+DECLARE_GPU_STAT_NAMED(LookingGlassFrameGraph, TEXT("LookingGlass frame graph"));
 
 static FName LevelEditorModuleName(TEXT("LevelEditor"));
 
 FOnLookingGlassFrameReady FLookingGlassViewportClient::OnLookingGlassFrameReady;
 
+// Interleave the frame for the panel with the current device calibration
+static void InitLenticularDesc(LookingGlass::FLenticularDesc& Lenticular, const FIntPoint& Tiles)
+{
+	const FLGDeviceCalibration& Calibration = ILookingGlassRuntime::Get().GetCurrentCalibration();
+	Lenticular.bEnabled = Lenticular.Params.Init(Calibration);
+	Lenticular.Tiles = Tiles;
+	Lenticular.SubpixelCells = Calibration.SubpixelCells;
+	Lenticular.CellPatternMode = Calibration.CellPatternMode;
+}
+
 
 void FLookingGlassScreenshotRequest::RequestScreenshot(const FString & InFilename, bool bAddFilenameSuffix, FLookingGlassScreenshotRequest::FQuiltSettings InQuiltSettings)
 {
@@ -126,10 +142,13 @@ void FLookingGlassScreenshotRequest::CreateViewportScreenShotFilename(FString& I
 FLookingGlassViewportClient::FLookingGlassViewportClient()
 	: bIgnoreInput(false)
 	, CurrentMouseCursor(EMouseCursor::Default)
-	, StaticQuiltRT(nullptr)
+	, LastQuiltFrameIndex(INDEX_NONE)
+	, LastQuiltPresentTime(0)
+	, LastDrawTime(0)
 	, LastRenderedComponent(nullptr)
 	, LastViewportUpdateTime(0)
 	, bLastModeWas2D(false)
+	, bDumpNextFrameGraph(false)
 	, Viewport(nullptr)
 {
 #if WITH_EDITOR
@@ -153,12 +172,19 @@ FLookingGlassViewportClient::~FLookingGlassViewportClient()
 		FEditorSupportDelegates::RedrawAllViewports.RemoveAll(this);
 	}
 #endif
-	// Stop rendering, hide window
+	// Stop rendering, hide window. Doesn't wait for display enumeration, Bridge calls are serialized with it.
 	FLookingGlassBridge& Bridge = ILookingGlassRuntime::Get().GetBridge();
 	if (Bridge.bInitialized)
 	{
 		Bridge.StopRendering();
 	}
+	// Deliver frames which are still being read back, and finish writing screenshots
+	QuiltReadbacks.Reset();
+	FlushScreenShotSaves();
+	if (UObjectInitialized() && !GExitPurge)
+	{
+		ReleaseQuiltFrames();
+	}
 }
 
 #if WITH_EDITOR
@@ -173,74 +199,14 @@ void FLookingGlassViewportClient::OnRedrawViewport(bool bInvalidateHitProxies)
 }
 #endif // WITH_EDITOR
 
-// A helper function which is copying one texture (render targer) to another one.
-// Taken from FGameplayMediaEncoder::CopyTexture() (exact copy of the code).
-static void CopyTexture(const FTextureRHIRef& SourceTexture, FTextureRHIRef& DestinationTexture)
-{
-	FRHICommandListImmediate& RHICmdList = FRHICommandListExecutor::GetImmediateCommandList();
-
-	if (SourceTexture->GetFormat() == DestinationTexture->GetFormat() && SourceTexture->GetSizeXY() == DestinationTexture->GetSizeXY())
-	{
-		TransitionAndCopyTexture(RHICmdList, SourceTexture, DestinationTexture, {});
-	}
-	else // Texture format mismatch, use a shader to do the copy.
-	{
-		IRendererModule* RendererModule = &FModuleManager::GetModuleChecked<IRendererModule>("Renderer");
-
-		// #todo-renderpasses there's no explicit resolve here? Do we need one?
-		FRHIRenderPassInfo RPInfo(DestinationTexture, ERenderTargetActions::Load_Store);
-
-		RHICmdList.Transition(FRHITransitionInfo(DestinationTexture, ERHIAccess::Unknown, ERHIAccess::RTV));
-		RHICmdList.BeginRenderPass(RPInfo, TEXT("CopyBackbuffer"));
-
-		{
-			RHICmdList.SetViewport(0, 0, 0.0f, (float)DestinationTexture->GetSizeX(), (float)DestinationTexture->GetSizeY(), 1.0f);
-
-			FGraphicsPipelineStateInitializer GraphicsPSOInit;
-			RHICmdList.ApplyCachedRenderTargets(GraphicsPSOInit);
-			GraphicsPSOInit.BlendState = TStaticBlendState<>::GetRHI();
-			GraphicsPSOInit.RasterizerState = TStaticRasterizerState<>::GetRHI();
-			GraphicsPSOInit.DepthStencilState = TStaticDepthStencilState<false, CF_Always>::GetRHI();
-
-			// New engine version...
-			FGlobalShaderMap* ShaderMap = GetGlobalShaderMap(GMaxRHIFeatureLevel);
-			TShaderMapRef<FScreenVS> VertexShader(ShaderMap);
-			TShaderMapRef<FScreenPS> PixelShader(ShaderMap);
-
-			GraphicsPSOInit.BoundShaderState.VertexDeclarationRHI = GFilterVertexDeclaration.VertexDeclarationRHI;
-			GraphicsPSOInit.BoundShaderState.VertexShaderRHI = VertexShader.GetVertexShader();
-			GraphicsPSOInit.BoundShaderState.PixelShaderRHI = PixelShader.GetPixelShader();
-
-			GraphicsPSOInit.PrimitiveType = PT_TriangleList;
-
-			SetGraphicsPipelineState(RHICmdList, GraphicsPSOInit, 0);
-
-			const bool bSameSize = (DestinationTexture->GetDesc().Extent == SourceTexture->GetDesc().Extent);
-			FRHISamplerState* PixelSampler = bSameSize ? TStaticSamplerState<SF_Point>::GetRHI() : TStaticSamplerState<SF_Bilinear>::GetRHI();
-
-			SetShaderParametersLegacyPS(RHICmdList, PixelShader, PixelSampler, SourceTexture);
-
-			RendererModule->DrawRectangle(RHICmdList, 0, 0,                // Dest X, Y
-				(float)DestinationTexture->GetSizeX(),  // Dest Width
-				(float)DestinationTexture->GetSizeY(),  // Dest Height
-				0, 0,                            // Source U, V
-				1, 1,                            // Source USize, VSize
-				DestinationTexture->GetSizeXY(), // Target buffer size
-				FIntPoint(1, 1),                 // Source texture size
-				VertexShader, EDRF_Default);
-		}
-
-		RHICmdList.EndRenderPass();
-		RHICmdList.Transition(FRHITransitionInfo(DestinationTexture, ERHIAccess::RTV, ERHIAccess::SRVMask));
-	}
-}
-
 void FLookingGlassViewportClient::Draw(FViewport* InViewport, FCanvas* InCanvas)
 {
 	check(IsInGameThread());
 
 	SCOPE_CYCLE_COUNTER(STAT_Draw_GameThread);
 
+	LastDrawTime = FPlatformTime::Seconds();
+
 	const ULookingGlassSettings* LookingGlassSettings = GetDefault<ULookingGlassSettings>();
 	const FLookingGlassRenderingSettings& RenderingSettings = LookingGlassSettings->LookingGlassRenderingSettings;
 	TWeakObjectPtr<ULookingGlassSceneCaptureComponent2D> LookingGlassCaptureComponent = LookingGlass::GetGameLookingGlassCaptureComponent();
@@ -255,6 +221,13 @@ void FLookingGlassViewportClient::Draw(FViewport* InViewport, FCanvas* InCanvas)
 	// Clear entire canvas
 	InCanvas->Clear(FLinearColor::Black);
 
+	// Deliver screenshots and movie frames which were read back from GPU
+	if (!QuiltReadbacks.IsValid() || QuiltReadbacks->GetRingSize() != RenderingSettings.ReadbackRingSize)
+	{
+		QuiltReadbacks = MakeUnique<LookingGlass::FQuiltReadbackRing>(RenderingSettings.ReadbackRingSize);
+	}
+	QuiltReadbacks->Tick();
+
 	if (!LookingGlassCaptureComponent.IsValid())
 	{
 		InCanvas->Clear(FLinearColor::Blue);
@@ -263,13 +236,21 @@ void FLookingGlassViewportClient::Draw(FViewport* InViewport, FCanvas* InCanvas)
 
 	// Create render QuiltRT if not exists
 	bool bRenderOnDevice = ILookingGlassRuntime::Get().IsRenderingOnDevice();
+	// Don't wait for Bridge when it's re-reading displays, render with the default calibration until it's done
 	FLookingGlassBridge& Bridge = ILookingGlassRuntime::Get().GetBridge();
-	if (!Bridge.bInitialized)
+	if (!ILookingGlassRuntime::Get().IsBridgeReady() || !Bridge.bInitialized)
+	{
+		bRenderOnDevice = false;
+	}
+	// When the plugin interleaves the hologram itself, the window is on the panel, and Bridge doesn't present anything
+	const bool bInterleaveInEngine = bRenderOnDevice && ILookingGlassRuntime::Get().IsInterleavingInEngine();
+	if (bInterleaveInEngine)
 	{
 		bRenderOnDevice = false;
 	}
 
-	UTextureRenderTarget2D* QuiltRT = GetQuiltRT(LookingGlassCaptureComponent);
+	// Number of quilt render targets could be changed in settings
+	UpdateQuiltRing(RenderingSettings.bPipelinedFrames ? RenderingSettings.QuiltRingSize : 1);
 
 	if (LookingGlassCaptureComponent->GetRenderingConfigs().Configs.Num() == 0)
 	{
@@ -311,32 +292,29 @@ void FLookingGlassViewportClient::Draw(FViewport* InViewport, FCanvas* InCanvas)
 		// Render a single picture to render target
 		LookingGlassCaptureComponent->Render2DView();
 
-		FTextureRenderTargetResource* RenderTarget = LookingGlassCaptureComponent->GetTextureTarget2DRendering()->GameThread_GetRenderTargetResource();
+		LookingGlass::FFrameGraphDesc GraphDesc;
+		GraphDesc.FullImageSource = LookingGlassCaptureComponent->GetTextureTarget2DRendering()->GameThread_GetRenderTargetResource();
 		if (bRenderOnDevice)
 		{
 			// Copy render target to QuiltRT, as it has compatible with Bridge texture format
-			FTextureRenderTargetResource* QuiltRenderTarget = QuiltRT->GameThread_GetRenderTargetResource();
-			ENQUEUE_RENDER_COMMAND(Render2DToDevice)(
-				[RenderTarget, QuiltRenderTarget](FRHICommandListImmediate& RHICmdList)
-				{
-					FTextureRHIRef TargetRT = QuiltRenderTarget->GetRenderTargetTexture();
-					CopyTexture(RenderTarget->GetRenderTargetTexture(), TargetRT);
-				}
-			);
+			const int32 PreviousFrameIndex = LastQuiltFrameIndex;
+			const int32 FrameIndex = AcquireQuiltFrame(LookingGlassCaptureComponent);
+			GraphDesc.QuiltTargetResource = QuiltFrames[FrameIndex].QuiltRT->GameThread_GetRenderTargetResource();
+			ExecuteFrameGraph(GraphDesc);
+			SubmitQuiltFrame(FrameIndex, FIntPoint(1, 1), LookingGlassCaptureComponent->GetAspectRatio());
+
 			// Now, visualize the QuiltRT on device
-			VisualizeRenderTarget(InViewport, QuiltRT, true, FIntPoint(1, 1), LookingGlassCaptureComponent->GetAspectRatio());
+			PresentQuiltFrame(RenderingSettings.bPipelinedFrames && PreviousFrameIndex != INDEX_NONE ? PreviousFrameIndex : FrameIndex);
 		}
 		else
 		{
 			// Copy rendered picture to viewport
-			FTextureRHIRef ViewportRT = InViewport->GetRenderTargetTexture();
-			ENQUEUE_RENDER_COMMAND(Render2DToViewport)(
-				[RenderTarget, InViewport](FRHICommandListImmediate& RHICmdList)
-				{
-					FTextureRHIRef ViewportRT = InViewport->GetRenderTargetTexture();
-					CopyTexture(RenderTarget->GetRenderTargetTexture(), ViewportRT);
-				}
-			);
+			GraphDesc.OutputViewport = InViewport;
+			if (bInterleaveInEngine)
+			{
+				InitLenticularDesc(GraphDesc.Lenticular, FIntPoint(1, 1));
+			}
+			ExecuteFrameGraph(GraphDesc);
 		}
 
 		bLastModeWas2D = true;
@@ -390,97 +368,168 @@ void FLookingGlassViewportClient::Draw(FViewport* InViewport, FCanvas* InCanvas)
 #endif // WITH_EDITOR
 
 	// Render scene to quilt. Update only when bShouldRender is true. If it is false, then previously rendered picture will be reused.
+	// When frames are pipelined, every rendered frame goes to the next quilt of the ring, and the previous one is presented.
+	const int32 PreviousFrameIndex = LastQuiltFrameIndex;
+	const int32 FrameIndex = (bShouldRender || LastQuiltFrameIndex == INDEX_NONE) ? AcquireQuiltFrame(LookingGlassCaptureComponent) : LastQuiltFrameIndex;
+	UTextureRenderTarget2D* QuiltRT = QuiltFrames[FrameIndex].QuiltRT;
+
+	// All post-capture work of the frame (quilt assembly, copy to the debug window) is recorded into a single render graph
+	LookingGlass::FFrameGraphDesc GraphDesc;
+	GraphDesc.QuiltTargetResource = QuiltRT->GameThread_GetRenderTargetResource();
+	GraphDesc.TilingValues = LookingGlassCaptureComponent->GetTilingValues();
+	GraphDesc.QuiltOrder = RenderingSettings.QuiltOrder;
+
 	if (bShouldRender)
 	{
+		if (bPendingQuiltScreenshot || bIsRecordingMovie || PerfMode == ELookingGlassPerformanceMode::NonRealtime)
+		{
+			// Captured pictures and non-realtime frames should have all views up to date
+			LookingGlassCaptureComponent->RequestFullRefresh();
+		}
+
 		// Render the actual scene to quilt texture
-		RenderToQuilt(LookingGlassCaptureComponent.Get(), QuiltRT);
+		RenderToQuilt(LookingGlassCaptureComponent.Get(), QuiltRT, GraphDesc);
 	}
 
-	// Synchronize game and rendering thread
-	FlushRenderingCommands();
-
-	// Pass composed quilt to target: either device or debug window
+	// Tiles of the quilt shown on device, the quilt is shown as a whole in quilt mode
 	FIntPoint Tiles(1, 1);
 	if (!RenderingSettings.QuiltMode && !bShow2D)
 	{
-		// Show quilt on device by disabling any tiling
 		const FLookingGlassTilingQuality& TilingValues = LookingGlassCaptureComponent->GetTilingValues();
 		Tiles.X = TilingValues.TilesX;
 		Tiles.Y = TilingValues.TilesY;
 	}
-	VisualizeRenderTarget(InViewport, QuiltRT, bRenderOnDevice, Tiles, LookingGlassCaptureComponent->GetAspectRatio());
 
+	if (!bRenderOnDevice)
+	{
+		GraphDesc.OutputViewport = InViewport;
+		if (bInterleaveInEngine)
+		{
+			InitLenticularDesc(GraphDesc.Lenticular, Tiles);
+		}
+	}
+
+	// Screenshots and movie frames are read back from the current quilt asynchronously
 	if (OnLookingGlassFrameReady.IsBound())
 	{
-		ProcessQuiltForMovie(QuiltRT);
+		ProcessQuiltForMovie(GraphDesc);
 	}
 	else
 	{
-		ProcessScreenshotQuilt(QuiltRT);
+		ProcessScreenshotQuilt(GraphDesc);
+	}
+
+	ExecuteFrameGraph(GraphDesc);
+
+	// Pass composed quilt to target: either device or debug window
+	if (FrameIndex != PreviousFrameIndex)
+	{
+		SubmitQuiltFrame(FrameIndex, Tiles, LookingGlassCaptureComponent->GetAspectRatio());
+	}
+
+	if (!RenderingSettings.bPipelinedFrames)
+	{
+		// Synchronize game and rendering thread
+		FlushRenderingCommands();
+	}
+
+	if (bRenderOnDevice)
+	{
+		// The debug window already got the picture from the frame graph
+		const bool bPresentPrevious = RenderingSettings.bPipelinedFrames && PreviousFrameIndex != INDEX_NONE;
+		PresentQuiltFrame(bPresentPrevious ? PreviousFrameIndex : FrameIndex);
 	}
 }
 
-void FLookingGlassViewportClient::VisualizeRenderTarget(FViewport* InViewport, UTextureRenderTarget2D* QuiltRT, bool bRenderOnDevice, const FIntPoint& Tiles, float Aspect)
+void FLookingGlassViewportClient::VisualizeRenderTarget(UTextureRenderTarget2D* QuiltRT, const FIntPoint& Tiles, float Aspect)
 {
-	// Pass composed quilt to target: either device or debug window
+	// Pass composed quilt to device. The frame graph has already left it in shader resource state.
 	FTextureRenderTargetResource* RenderTarget = QuiltRT->GameThread_GetRenderTargetResource();
 	if (!RenderTarget->GetTexture2DRHI())
 	{
 		return;
 	}
 
-	if (bRenderOnDevice)
+	// Prepare Bridge if needed
+	FLookingGlassBridge& Bridge = ILookingGlassRuntime::Get().GetBridge();
+	void* RTNativeHandle = RenderTarget->GetTexture2DRHI()->GetNativeResource();
+	if (!Bridge.IsRendering())
 	{
-		// Prepare Bridge if needed
-		FLookingGlassBridge& Bridge = ILookingGlassRuntime::Get().GetBridge();
-#if 1
-		void* RTNativeHandle = RenderTarget->GetTexture2DRHI()->GetNativeResource();
-		if (!Bridge.IsRendering())
-		{
-			Bridge.StartRendering();
-		}
-		// Then render
-		Bridge.DrawTexture(RTNativeHandle, Tiles.X, Tiles.Y, Aspect);
-#else
-		// Do the sync with device in rendering thread. For some reason, at least with Bridge 2.4.9 it hangs
-		// in Bridge API.
-		if (!Bridge.IsRendering())
-		{
-			Bridge.StartRendering();
-		}
-		// Then render
-		ENQUEUE_RENDER_COMMAND(CopyQuiltRTToBridge)(
-			[&Bridge, RenderTarget, Tiles](FRHICommandListImmediate& RHICmdList)
-			{
-				void* RTNativeHandle = RenderTarget->GetTexture2DRHI()->GetNativeResource();
-				Bridge.DrawTexture(RTNativeHandle, Tiles.X, Tiles.Y, Aspect);
-			}
-		);
-#endif
+		Bridge.StartRendering();
 	}
-	else
-	{
-		// Copy QuiltRT to viewport. Can't render things directly there, because of some texture type
-		// incompatibilities - the viewport's RT is not URenderTarget or any other types used here.
-		FTextureRHIRef ViewportRT = InViewport->GetRenderTargetTexture();
+	// Then render. Note: doing the sync with device in rendering thread hangs, at least with Bridge 2.4.9,
+	// so this call stays on the game thread.
+	Bridge.DrawTexture(RTNativeHandle, Tiles.X, Tiles.Y, Aspect);
+}
 
-		ENQUEUE_RENDER_COMMAND(CopyQuiltRTToViewport)(
-			[RenderTarget, InViewport](FRHICommandListImmediate& RHICmdList)
-			{
-				FTextureRHIRef ViewportRT = InViewport->GetRenderTargetTexture();
-				CopyTexture(RenderTarget->GetRenderTargetTexture(), ViewportRT);
-			}
-		);
+void FLookingGlassViewportClient::ExecuteFrameGraph(LookingGlass::FFrameGraphDesc& GraphDesc)
+{
+	GraphDesc.bDumpGraph = bDumpNextFrameGraph;
+	bDumpNextFrameGraph = false;
+
+	if (!GraphDesc.HasWork())
+	{
+		return;
 	}
+
+	ENQUEUE_RENDER_COMMAND(LookingGlassFrameGraph)(
+		[GraphDesc = MoveTemp(GraphDesc)](FRHICommandListImmediate& RHICmdList)
+		{
+			SCOPE_CYCLE_COUNTER(STAT_FrameGraph_RenderThread);
+			SCOPED_GPU_STAT(RHICmdList, LookingGlassFrameGraph);
+
+			LookingGlass::ExecuteFrameGraph_RenderThread(RHICmdList, GraphDesc);
+		});
 }
 
-void FLookingGlassViewportClient::RenderToQuilt(ULookingGlassSceneCaptureComponent2D* CaptureComponent, UTextureRenderTarget2D* InQuiltRT)
+void FLookingGlassViewportClient::RenderToQuilt(ULookingGlassSceneCaptureComponent2D* CaptureComponent, UTextureRenderTarget2D* InQuiltRT, LookingGlass::FFrameGraphDesc& GraphDesc)
 {
+	if (CaptureComponent->IsRenderingDirectToQuilt())
+	{
+		// Views are rendered in place, at their quilt tiles, so there's nothing to copy
+		CaptureComponent->RenderViews(InQuiltRT);
+		return;
+	}
+
 	// Render to multiple render targets
 	CaptureComponent->RenderViews();
 
+	// Quilt tile ordering
+	const FLookingGlassRenderingSettings& LGRenderingSettings = GetDefault<ULookingGlassSettings>()->LookingGlassRenderingSettings;
+	ELookingGlassQuiltOrder QuiltOrder = LGRenderingSettings.QuiltOrder;
+
+	if (LGRenderingSettings.bBatchedQuiltCopy)
+	{
+		// Tiling render targets are copied into the quilt by the frame graph, with a single render pass
+		for (const FLookingGlassRenderingConfig& RenderingConfig : CaptureComponent->GetRenderingConfigs().Configs)
+		{
+			UTextureRenderTarget2D* RenderTarget = RenderingConfig.GetRenderTarget();
+			if (RenderTarget == nullptr || RenderTarget->GetResource() == nullptr)
+			{
+				UE_LOG(LookingGlassLogRender, Error, TEXT("RenderTarget is null"));
+
+				GraphDesc.Sources.Empty();
+				return;
+			}
+
+			GraphDesc.Sources.Add({
+				RenderTarget->GetResource(),
+				RenderingConfig.GetQuiltViewIndices(),
+				RenderingConfig.GetViewInfoArr().Num(),
+				RenderingConfig.GetViewRows(),
+				RenderingConfig.GetViewColumns(),
+				RenderingConfig.GetDepthCapture(),
+				RenderingConfig.GetViewScales()
+			});
+		}
+
+		// Fill quilt tiles of views which weren't rendered
+		LookingGlass::SetupViewSynthesis(CaptureComponent, GraphDesc);
+
+		return;
+	}
+
 	// Copy data from multiple render targets into a single quilt image
-	uint32 CurrentViewIndex = 0;
 	for (const FLookingGlassRenderingConfig& RenderingConfig : CaptureComponent->GetRenderingConfigs().Configs)
 	{
 		UTextureRenderTarget2D* RenderTarget = RenderingConfig.GetRenderTarget();
@@ -493,10 +542,7 @@ void FLookingGlassViewportClient::RenderToQuilt(ULookingGlassSceneCaptureCompone
 
 		for (int32 ViewIndex = 0; ViewIndex < RenderingConfig.GetViewInfoArr().Num(); ++ViewIndex)
 		{
-			// Backward-compat: if enum is default legacy but old boolean is true, prefer TopLeft order
-			const FLookingGlassRenderingSettings& LGRenderingSettings = GetDefault<ULookingGlassSettings>()->LookingGlassRenderingSettings;
-			ELookingGlassQuiltOrder QuiltOrder = LGRenderingSettings.QuiltOrder;
-			
+			const uint32 CurrentViewIndex = RenderingConfig.GetQuiltViewIndex(ViewIndex);
 			LookingGlass::FCopyToQuiltRenderContext RenderContext =
 			{
 				InQuiltRT->GameThread_GetRenderTargetResource(),
@@ -508,7 +554,8 @@ void FLookingGlassViewportClient::RenderToQuilt(ULookingGlassSceneCaptureCompone
 				RenderingConfig.GetViewRows(),
 				RenderingConfig.GetViewColumns(),
 				RenderingConfig.GetViewInfoArr()[ViewIndex],
-				QuiltOrder
+				QuiltOrder,
+				RenderingConfig.GetViewScales()[ViewIndex]
 			};
 
 			ENQUEUE_RENDER_COMMAND(CopyToQuiltCommand)(
@@ -516,11 +563,11 @@ void FLookingGlassViewportClient::RenderToQuilt(ULookingGlassSceneCaptureCompone
 				{
 					SCOPE_CYCLE_COUNTER(STAT_CopyToQuiltShader_RenderThread);
 					SCOPED_GPU_STAT(RHICmdList, CopyToQuilt);
+					INC_DWORD_STAT(STAT_QuiltCopyPasses);
+					INC_DWORD_STAT(STAT_QuiltCopyDraws);
 
 					LookingGlass::CopyToQuiltShader_RenderThread(RHICmdList, RenderContext);
 				});
-
-			CurrentViewIndex++;
 		}
 	}
 }
@@ -873,28 +920,6 @@ void FLookingGlassViewportClient::RedrawRequested(FViewport * InViewport)
 	Viewport->Draw();
 }
 
-bool FLookingGlassViewportClient::GetRenderTargetScreenShot(TWeakObjectPtr<UTextureRenderTarget2D> TextureRenderTarget2D, TArray<FColor>& Bitmap, const FIntRect& ViewRect)
-{
-	// Read the contents of the viewport into an array.
-	FReadSurfaceDataFlags ReadSurfaceDataFlags;
-	ReadSurfaceDataFlags.SetLinearToGamma(false); // This is super important to disable this!
-
-	bool bIsSuccess = false;
-	FTextureRenderTargetResource* RenderTarget = TextureRenderTarget2D->GameThread_GetRenderTargetResource();
-	if (RenderTarget->ReadPixels(Bitmap, ReadSurfaceDataFlags, ViewRect))
-	{
-		check(Bitmap.Num() == ViewRect.Area() || (Bitmap.Num() == TextureRenderTarget2D->SizeX * TextureRenderTarget2D->SizeY));
-		for (FColor& color : Bitmap)
-		{
-			color.A = 255;
-		}
-
-		bIsSuccess = true;
-	}
-
-	return bIsSuccess;
-}
-
 //todo: unused function
 static void ClipScreenshot(FIntVector& Size, FIntRect& SourceRect, TArray<FColor>& Bitmap)
 {
@@ -919,7 +944,7 @@ static void ClipScreenshot(FIntVector& Size, FIntRect& SourceRect, TArray<FColor
 	}
 }
 
-void FLookingGlassViewportClient::ProcessScreenshotQuilt(UTextureRenderTarget2D* InQuiltRT)
+void FLookingGlassViewportClient::ProcessScreenshotQuilt(LookingGlass::FFrameGraphDesc& GraphDesc)
 {
 	if (LookingGlassQuiltScreenshotRequest.IsValid())
 	{
@@ -929,33 +954,44 @@ void FLookingGlassViewportClient::ProcessScreenshotQuilt(UTextureRenderTarget2D*
 			return;
 		}
 
-		TArray<FColor> Bitmap;
-		bool bScreenshotSuccessful = GetRenderTargetScreenShot(InQuiltRT, Bitmap);
-		if ( bScreenshotSuccessful )
-		{
-			FIntVector Size( InQuiltRT->SizeX, InQuiltRT->SizeY, 0 );
-			const ULookingGlassSettings* LookingGlassSettings = GetDefault<ULookingGlassSettings>();
-			SaveScreenShot(Bitmap, Size, LookingGlassQuiltScreenshotRequest->GetFilename(), &LookingGlassSettings->LookingGlassScreenshotQuiltSettings);
-		}
+		// The request is completed when the quilt arrives from GPU, a new one could be made in the meantime
+		TSharedPtr<FLookingGlassScreenshotRequest> Request = LookingGlassQuiltScreenshotRequest;
+		LookingGlassQuiltScreenshotRequest.Reset();
 
-		// Notify about completion
-		LookingGlassQuiltScreenshotRequest->ExecCallback();
+		GraphDesc.Readback = QuiltReadbacks->BeginReadback(
+			[this, Request](const FLookingGlassPixelBufferPtr& Buffer)
+			{
+				if (!Buffer.IsValid())
+				{
+					Request->ExecCallback();
+					OnScreenshotQuiltRequestProcessed().Broadcast();
+					return;
+				}
 
-		LookingGlassQuiltScreenshotRequest.Reset();
-		OnScreenshotQuiltRequestProcessed().Broadcast();
+				// Notify about completion when the file is written
+				const ULookingGlassSettings* LookingGlassSettings = GetDefault<ULookingGlassSettings>();
+				SaveScreenShotAsync(Buffer.ToSharedRef(), Request->GetFilename(), LookingGlassSettings->LookingGlassScreenshotQuiltSettings,
+					[this, Request]()
+					{
+						Request->ExecCallback();
+						OnScreenshotQuiltRequestProcessed().Broadcast();
+					});
+			});
 	}
 }
 
-void FLookingGlassViewportClient::ProcessQuiltForMovie(UTextureRenderTarget2D* InQuiltRT)
+void FLookingGlassViewportClient::ProcessQuiltForMovie(LookingGlass::FFrameGraphDesc& GraphDesc)
 {
 	if (OnLookingGlassFrameReady.IsBound())
 	{
-		TArray<FColor> Bitmap;
-		bool bScreenshotSuccessful = GetRenderTargetScreenShot(InQuiltRT, Bitmap);
-		if (bScreenshotSuccessful)
-		{
-			OnLookingGlassFrameReady.Broadcast(Bitmap, InQuiltRT->SizeX, InQuiltRT->SizeY);
-		}
+		GraphDesc.Readback = QuiltReadbacks->BeginReadback(
+			[](const FLookingGlassPixelBufferPtr& Buffer)
+			{
+				if (Buffer.IsValid())
+				{
+					OnLookingGlassFrameReady.Broadcast(Buffer.ToSharedRef());
+				}
+			});
 	}
 }
 
@@ -981,33 +1017,47 @@ void FLookingGlassViewportClient::ProcessScreenshot2D(TWeakObjectPtr<ULookingGla
 
 		// Render picture
 		LookingGlassCaptureComponent->Render2DView(ScreenshotResolutionX, ScreenshotResolutionY);
-		// grab the render target where picture was rendered
+		// grab the render target where picture was rendered, and read it back without waiting for GPU
 		UTextureRenderTarget2D* RenderTarget = LookingGlassCaptureComponent->GetTextureTarget2DRendering();
 
-		TArray<FColor> Bitmap;
-		bool bScreenshotSuccessful = GetRenderTargetScreenShot(RenderTarget, Bitmap);
+		TSharedPtr<FLookingGlassScreenshotRequest> Request = LookingGlassScreenshot2DRequest;
+		LookingGlassScreenshot2DRequest.Reset();
 
-		if (bScreenshotSuccessful)
-		{
-			FIntVector Size( RenderTarget->SizeX, RenderTarget->SizeY, 0 );
-			const ULookingGlassSettings* LookingGlassSettings = GetDefault<ULookingGlassSettings>();
-			SaveScreenShot(Bitmap, Size, LookingGlassScreenshot2DRequest->GetFilename(), &LookingGlassSettings->LookingGlassScreenshot2DSettings);
-		}
+		LookingGlass::FFrameGraphDesc GraphDesc;
+		GraphDesc.FullImageSource = RenderTarget->GameThread_GetRenderTargetResource();
+		GraphDesc.Readback = QuiltReadbacks->BeginReadback(
+			[this, Request](const FLookingGlassPixelBufferPtr& Buffer)
+			{
+				if (!Buffer.IsValid())
+				{
+					Request->ExecCallback();
+					OnScreenshot2DRequestProcessed().Broadcast();
+					return;
+				}
 
-		LookingGlassScreenshot2DRequest.Reset();
-		OnScreenshot2DRequestProcessed().Broadcast();
+				const ULookingGlassSettings* LookingGlassSettings = GetDefault<ULookingGlassSettings>();
+				SaveScreenShotAsync(Buffer.ToSharedRef(), Request->GetFilename(), LookingGlassSettings->LookingGlassScreenshot2DSettings,
+					[this, Request]()
+					{
+						Request->ExecCallback();
+						OnScreenshot2DRequestProcessed().Broadcast();
+					});
+			});
+		ExecuteFrameGraph(GraphDesc);
 	}
 }
 
-void FLookingGlassViewportClient::SaveScreenShot(const TArray<FColor>& Bitmap, const FIntVector& Size, const FString& InScreenShotName, const FLookingGlassScreenshotSettings* pScreenShotSettings)
+void FLookingGlassViewportClient::SaveScreenShotAsync(const FLookingGlassPixelBufferRef& Buffer, const FString& InScreenShotName, const FLookingGlassScreenshotSettings& ScreenShotSettings, TUniqueFunction<void()>&& OnSaved)
 {
+	check(IsInGameThread());
+
 	FString Extension = TEXT(".png");
 	int32 Quality = 0;
-	bool bUseJpg = pScreenShotSettings->UseJPG;
+	bool bUseJpg = ScreenShotSettings.UseJPG;
 	if (bUseJpg)
 	{
 		Extension = TEXT(".jpg");
-		Quality = pScreenShotSettings->JpegQuality;
+		Quality = ScreenShotSettings.JpegQuality;
 	}
 
 	FString ScreenShotName = InScreenShotName;
@@ -1017,34 +1067,62 @@ void FLookingGlassViewportClient::SaveScreenShot(const TArray<FColor>& Bitmap, c
 		ScreenShotName += Extension;
 	}
 
-#if ENGINE_MAJOR_VERSION >= 5 && ENGINE_MINOR_VERSION >= 1
-	FImageView ImageView(Bitmap.GetData(), Size.X, Size.Y);
-	FImageUtils::SaveImageByExtension(*ScreenShotName, ImageView, Quality);
-#else
-	// Implement image saving directly
-	IImageWrapperModule* ImageWrapperModule = FModuleManager::GetModulePtr<IImageWrapperModule>(TEXT("ImageWrapper"));
-	if (!ensure( ImageWrapperModule ))
-	{
-		UE_LOG( LookingGlassLogInput, Verbose, TEXT( "Could not find image wrapper module, Screenshot aborted" ) );
-		return;
-	}
-	EImageFormat imageFormat = EImageFormat::PNG;
-	if (bUseJpg)
-	{
-		imageFormat = EImageFormat::JPEG;
-	}
+	NumScreenShotSaves.Increment();
+	SET_DWORD_STAT(STAT_ScreenshotSavesInFlight, NumScreenShotSaves.GetValue());
+
+	// Encode, then write the file. The pixel buffer returns to the pool when the task releases it.
+	Async(EAsyncExecution::ThreadPool,
+		[this, Buffer, ScreenShotName, bUseJpg, Quality, OnSaved = MoveTemp(OnSaved)]() mutable
+		{
+			TArray64<uint8> CompressedBitmap;
+			bool bEncoded = false;
+			{
+				// Quilts could be 8K and larger, so they're encoded in parallel strips instead of using ImageWrapper
+				SCOPE_CYCLE_COUNTER(STAT_EncodeScreenshot);
+				bEncoded = bUseJpg
+					? LookingGlass::ImageEncoder::EncodeJPEG(Buffer->Pixels.GetData(), Buffer->Size.X, Buffer->Size.Y, Quality, CompressedBitmap)
+					: LookingGlass::ImageEncoder::EncodePNG(Buffer->Pixels.GetData(), Buffer->Size.X, Buffer->Size.Y, CompressedBitmap);
+			}
+
+			if (!bEncoded)
+			{
+				UE_LOG(LookingGlassLogGame, Warning, TEXT("Unable to encode screenshot %s"), *ScreenShotName);
+			}
+			else
+			{
+				SCOPE_CYCLE_COUNTER(STAT_WriteScreenshot);
+				if (!FFileHelper::SaveArrayToFile(CompressedBitmap, *ScreenShotName))
+				{
+					UE_LOG(LookingGlassLogGame, Warning, TEXT("Unable to write screenshot %s"), *ScreenShotName);
+				}
+			}
+
+			AsyncTask(ENamedThreads::GameThread,
+				[this, OnSaved = MoveTemp(OnSaved)]()
+				{
+					if (OnSaved)
+					{
+						OnSaved();
+					}
+					NumScreenShotSaves.Decrement();
+					SET_DWORD_STAT(STAT_ScreenshotSavesInFlight, NumScreenShotSaves.GetValue());
+				});
+		});
+}
+
+void FLookingGlassViewportClient::FlushScreenShotSaves()
+{
+	check(IsInGameThread());
 
-	TSharedPtr<IImageWrapper> NewImageWrapper = ImageWrapperModule->CreateImageWrapper( imageFormat );
-	if (!ensureMsgf( NewImageWrapper.IsValid(), TEXT( "Unable to create an image wrapper for the desired format." ) ))
+	// Completion callbacks are queued to game thread, so process its tasks while waiting
+	while (NumScreenShotSaves.GetValue() > 0)
 	{
-		UE_LOG( LookingGlassLogInput, Verbose, TEXT( "Unable to create an image wrapper for the desired format., Screenshot aborted" ) );
-		return;
+		FTaskGraphInterface::Get().ProcessThreadUntilIdle(ENamedThreads::GameThread);
+		if (NumScreenShotSaves.GetValue() > 0)
+		{
+			FPlatformProcess::Sleep(0.001f);
+		}
 	}
-	NewImageWrapper->SetRaw( Bitmap.GetData(), Size.X * Size.Y * 4, Size.X, Size.Y, ERGBFormat::BGRA, 8 );
-
-	TArray64<uint8> CompressedBitmap = NewImageWrapper->GetCompressed(Quality);
-	FFileHelper::SaveArrayToFile( CompressedBitmap, *ScreenShotName );
-#endif
 }
 
 EMouseCursor::Type FLookingGlassViewportClient::GetCursor(FViewport* InViewport, int32 X, int32 Y)
@@ -1085,6 +1163,10 @@ bool FLookingGlassViewportClient::Exec(UWorld * InWorld, const TCHAR * Cmd, FOut
 	{
 		return HandleRenderingCommand(Cmd, Ar);
 	}
+	else if (FParse::Command(&Cmd, TEXT("LookingGlass.DumpGraph")))
+	{
+		return HandleDumpGraphCommand(Cmd, Ar);
+	}
 	else
 	{
 		return false;
@@ -1189,6 +1271,15 @@ bool FLookingGlassViewportClient::HandleRenderingCommand(const TCHAR* Cmd, FOutp
 	return bWasHandled;
 }
 
+bool FLookingGlassViewportClient::HandleDumpGraphCommand(const TCHAR* Cmd, FOutputDevice& Ar)
+{
+	// The graph is logged from the rendering thread while the next frame is being drawn
+	bDumpNextFrameGraph = true;
+	Ar.Logf(TEXT("LookingGlass frame graph will be dumped to log on the next frame"));
+
+	return true;
+}
+
 void FLookingGlassViewportClient::ParseScreenshotCommand(const TCHAR * Cmd, FString& InName, bool& InSuffix)
 {
 	FString CmdString(Cmd);
@@ -1256,33 +1347,190 @@ bool FLookingGlassViewportClient::PrepareScreenshot2D(const FString& FileName, b
 	return false;
 }
 
-UTextureRenderTarget2D* FLookingGlassViewportClient::GetQuiltRT(TWeakObjectPtr<ULookingGlassSceneCaptureComponent2D> LookingGlassCaptureComponent)
+void FLookingGlassViewportClient::UpdateQuiltRing(int32 RingSize)
+{
+	RingSize = FMath::Clamp(RingSize, 1, 4);
+	if (QuiltFrames.Num() == RingSize)
+	{
+		return;
+	}
+
+	ReleaseQuiltFrames();
+	QuiltFrames.SetNum(RingSize);
+}
+
+void FLookingGlassViewportClient::ReleaseQuiltFrames()
+{
+	FLookingGlassBridge& Bridge = ILookingGlassRuntime::Get().GetBridge();
+	for (FQuiltFrame& Frame : QuiltFrames)
+	{
+		Frame.Fence.Wait();
+		for (void* StaleTexture : Frame.StaleBridgeTextures)
+		{
+			Bridge.UnregisterTexture(StaleTexture);
+		}
+		Bridge.UnregisterTexture(Frame.BridgeTexture);
+		if (Frame.QuiltRT != nullptr)
+		{
+			Frame.QuiltRT->RemoveFromRoot();
+		}
+	}
+	QuiltFrames.Empty();
+	LastQuiltFrameIndex = INDEX_NONE;
+	UpdateQuiltRingStats();
+}
+
+void FLookingGlassViewportClient::ReduceMemoryUse()
+{
+	if (QuiltFrames.Num() > 0)
+	{
+		UE_LOG(LookingGlassLogRender, Log, TEXT("Releasing quilt render targets, nothing has been drawn for a while"));
+		ReleaseQuiltFrames();
+	}
+}
+
+void FLookingGlassViewportClient::UpdateQuiltRingStats() const
+{
+	int64 Bytes = 0;
+	for (const FQuiltFrame& Frame : QuiltFrames)
+	{
+		if (Frame.QuiltRT != nullptr)
+		{
+			Bytes += FLookingGlassRenderTargetPool::GetTextureBytes(FIntPoint(Frame.QuiltRT->SizeX, Frame.QuiltRT->SizeY), Frame.QuiltRT->OverrideFormat);
+		}
+	}
+	SET_FLOAT_STAT(STAT_QuiltRingMemory, Bytes / (1024.0 * 1024.0));
+}
+
+void FLookingGlassViewportClient::RetireBridgeTexture(FQuiltFrame& Frame)
+{
+	if (Frame.BridgeTexture != nullptr)
+	{
+		Frame.StaleBridgeTextures.Add(Frame.BridgeTexture);
+		Frame.BridgeTexture = nullptr;
+	}
+}
+
+int32 FLookingGlassViewportClient::AcquireQuiltFrame(TWeakObjectPtr<ULookingGlassSceneCaptureComponent2D> LookingGlassCaptureComponent)
 {
 	const FLookingGlassTilingQuality& TilingValues = LookingGlassCaptureComponent->GetTilingValues();
+	const EPixelFormat QuiltFormat = FLookingGlassRenderingConfig::GetPixelFormat(LookingGlassCaptureComponent->PixelFormat);
+
+	const int32 FrameIndex = (LastQuiltFrameIndex + 1) % QuiltFrames.Num();
+	FQuiltFrame& Frame = QuiltFrames[FrameIndex];
+
+	// The ring is large enough to have this quilt already processed by rendering thread, so this should not block
+	WaitForQuiltFrame(Frame);
 
-	if (StaticQuiltRT == nullptr)
+	// Render targets are (re)created without flushing rendering commands: rendering thread initializes and clears the
+	// resource before the commands of this frame, and the frame isn't presented before its fence is passed.
+	if (Frame.QuiltRT == nullptr)
 	{
-		StaticQuiltRT = NewObject<UTextureRenderTarget2D>(GetTransientPackage(), UTextureRenderTarget2D::StaticClass());
-		StaticQuiltRT->AddToRoot();
+		Frame.QuiltRT = NewObject<UTextureRenderTarget2D>(GetTransientPackage(), UTextureRenderTarget2D::StaticClass());
+		Frame.QuiltRT->AddToRoot();
 
-		StaticQuiltRT->ClearColor = FLinearColor::Red;
+		Frame.QuiltRT->ClearColor = FLinearColor::Red;
 		// We should create a RT in particular pixel format, and make it shareable, in order to being able to use it in Bridge
-		StaticQuiltRT->bGPUSharedFlag = true;
-		StaticQuiltRT->InitCustomFormat(TilingValues.QuiltW, TilingValues.QuiltH, PF_A2B10G10R10, false);
-		StaticQuiltRT->UpdateResource();
-		StaticQuiltRT->UpdateResourceImmediate();
-		FlushRenderingCommands();
+		Frame.QuiltRT->bGPUSharedFlag = true;
+		Frame.QuiltRT->InitCustomFormat(TilingValues.QuiltW, TilingValues.QuiltH, QuiltFormat, false);
+		Frame.QuiltRT->UpdateResource();
+		Frame.QuiltRT->UpdateResourceImmediate();
+	}
+	else if (Frame.QuiltRT->OverrideFormat != QuiltFormat)
+	{
+		// Pixel format setting has been changed, the native texture will be recreated
+		RetireBridgeTexture(Frame);
+
+		Frame.QuiltRT->InitCustomFormat(TilingValues.QuiltW, TilingValues.QuiltH, QuiltFormat, false);
+		Frame.QuiltRT->UpdateResourceImmediate();
 	}
 
 	// Resize Quilt texture
-	if (TilingValues.QuiltW != StaticQuiltRT->SizeX ||
-		TilingValues.QuiltH != StaticQuiltRT->SizeY)
+	if (TilingValues.QuiltW != Frame.QuiltRT->SizeX ||
+		TilingValues.QuiltH != Frame.QuiltRT->SizeY)
 	{
-		StaticQuiltRT->ResizeTarget(TilingValues.QuiltW, TilingValues.QuiltH);
-		StaticQuiltRT->UpdateResource();
-		StaticQuiltRT->UpdateResourceImmediate();
-		FlushRenderingCommands();
+		// The native texture will be recreated, so Bridge should forget the old one
+		RetireBridgeTexture(Frame);
+
+		Frame.QuiltRT->ResizeTarget(TilingValues.QuiltW, TilingValues.QuiltH);
+		Frame.QuiltRT->UpdateResource();
+		Frame.QuiltRT->UpdateResourceImmediate();
+	}
+
+	UpdateQuiltRingStats();
+
+	return FrameIndex;
+}
+
+void FLookingGlassViewportClient::SubmitQuiltFrame(int32 FrameIndex, const FIntPoint& Tiles, float Aspect)
+{
+	FQuiltFrame& Frame = QuiltFrames[FrameIndex];
+	Frame.Tiles = Tiles;
+	Frame.Aspect = Aspect;
+	Frame.SubmitTime = FPlatformTime::Seconds();
+	Frame.bPresented = false;
+	Frame.Fence.BeginFence();
+
+	LastQuiltFrameIndex = FrameIndex;
+
+	uint32 FramesInFlight = 0;
+	for (const FQuiltFrame& Other : QuiltFrames)
+	{
+		FramesInFlight += Other.Fence.IsFenceComplete() ? 0 : 1;
+	}
+	SET_DWORD_STAT(STAT_QuiltFramesInFlight, FramesInFlight);
+}
+
+void FLookingGlassViewportClient::WaitForQuiltFrame(FQuiltFrame& Frame)
+{
+	if (Frame.Fence.IsFenceComplete())
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_WaitForQuiltFrame_GameThread);
+	const double StartTime = FPlatformTime::Seconds();
+	Frame.Fence.Wait();
+	SET_FLOAT_STAT(STAT_QuiltFrameWait, (FPlatformTime::Seconds() - StartTime) * 1000.0);
+}
+
+void FLookingGlassViewportClient::PresentQuiltFrame(int32 FrameIndex)
+{
+	FQuiltFrame& Frame = QuiltFrames[FrameIndex];
+
+	// Bridge reads the quilt right away, so rendering thread should be done with it
+	WaitForQuiltFrame(Frame);
+
+	// The fence covers recreation of the render target as well, so the replaced textures aren't used anymore
+	if (Frame.StaleBridgeTextures.Num() > 0)
+	{
+		FLookingGlassBridge& Bridge = ILookingGlassRuntime::Get().GetBridge();
+		for (void* StaleTexture : Frame.StaleBridgeTextures)
+		{
+			Bridge.UnregisterTexture(StaleTexture);
+		}
+		Frame.StaleBridgeTextures.Reset();
 	}
 
-	return StaticQuiltRT;
+	FTextureRenderTargetResource* RenderTarget = Frame.QuiltRT->GameThread_GetRenderTargetResource();
+	if (RenderTarget == nullptr || !RenderTarget->GetTexture2DRHI())
+	{
+		// Not recreated yet, skip this quilt until it is
+		return;
+	}
+	Frame.BridgeTexture = RenderTarget->GetTexture2DRHI()->GetNativeResource();
+	VisualizeRenderTarget(Frame.QuiltRT, Frame.Tiles, Frame.Aspect);
+
+	// Frame pacing and latency
+	const double Now = FPlatformTime::Seconds();
+	if (LastQuiltPresentTime > 0)
+	{
+		SET_FLOAT_STAT(STAT_QuiltPresentInterval, (Now - LastQuiltPresentTime) * 1000.0);
+	}
+	LastQuiltPresentTime = Now;
+	if (!Frame.bPresented)
+	{
+		SET_FLOAT_STAT(STAT_QuiltFrameLatency, (Now - Frame.SubmitTime) * 1000.0);
+		Frame.bPresented = true;
+	}
 }
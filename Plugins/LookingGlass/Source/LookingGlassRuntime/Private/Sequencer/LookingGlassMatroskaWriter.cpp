@@ -0,0 +1,336 @@
+#include "Sequencer/LookingGlassMatroskaWriter.h"
+
+#include "HAL/FileManager.h"
+#include "Serialization/Archive.h"
+
+#include "Misc/LookingGlassLog.h"
+
+using namespace LookingGlass;
+
+namespace
+{
+	// EBML and Matroska element IDs, see https://www.matroska.org/technical/elements.html
+	enum : uint32
+	{
+		EBML_Header				= 0x1A45DFA3,
+		EBML_Version			= 0x4286,
+		EBML_ReadVersion		= 0x42F7,
+		EBML_MaxIDLength		= 0x42F2,
+		EBML_MaxSizeLength		= 0x42F3,
+		EBML_DocType			= 0x4282,
+		EBML_DocTypeVersion		= 0x4287,
+		EBML_DocTypeReadVersion	= 0x4285,
+		EBML_Void				= 0xEC,
+
+		MKV_Segment				= 0x18538067,
+		MKV_SeekHead			= 0x114D9B74,
+		MKV_Seek				= 0x4DBB,
+		MKV_SeekID				= 0x53AB,
+		MKV_SeekPosition		= 0x53AC,
+		MKV_Info				= 0x1549A966,
+		MKV_TimestampScale		= 0x2AD7B1,
+		MKV_Duration			= 0x4489,
+		MKV_MuxingApp			= 0x4D80,
+		MKV_WritingApp			= 0x5741,
+		MKV_Title				= 0x7BA9,
+		MKV_Tracks				= 0x1654AE6B,
+		MKV_TrackEntry			= 0xAE,
+		MKV_TrackNumber			= 0xD7,
+		MKV_TrackUID			= 0x73C5,
+		MKV_TrackType			= 0x83,
+		MKV_FlagLacing			= 0x9C,
+		MKV_CodecID				= 0x86,
+		MKV_DefaultDuration		= 0x23E383,
+		MKV_Video				= 0xE0,
+		MKV_PixelWidth			= 0xB0,
+		MKV_PixelHeight			= 0xBA,
+		MKV_Cluster				= 0x1F43B675,
+		MKV_Timestamp			= 0xE7,
+		MKV_SimpleBlock			= 0xA3,
+		MKV_Cues				= 0x1C53BB6B,
+		MKV_CuePoint			= 0xBB,
+		MKV_CueTime				= 0xB3,
+		MKV_CueTrackPositions	= 0xB7,
+		MKV_CueTrack			= 0xF7,
+		MKV_CueClusterPosition	= 0xF1,
+	};
+
+	// Size of the space reserved for the seek head, which is written when the file is finalized
+	constexpr int32 SeekHeadReservedSize = 96;
+
+	// Timestamps are in milliseconds
+	constexpr uint64 TimestampScale = 1000000;
+
+	void WriteId(TArray<uint8>& Out, uint32 Id)
+	{
+		// IDs are stored with their length marker, so just write significant bytes
+		int32 NumBytes = Id > 0xFFFFFF ? 4 : Id > 0xFFFF ? 3 : Id > 0xFF ? 2 : 1;
+		for (int32 Index = NumBytes - 1; Index >= 0; Index--)
+		{
+			Out.Add((uint8)(Id >> (Index * 8)));
+		}
+	}
+
+	// Variable size integer; NumBytes = 0 selects the shortest encoding
+	void WriteSize(TArray<uint8>& Out, uint64 Size, int32 NumBytes = 0)
+	{
+		if (NumBytes == 0)
+		{
+			NumBytes = 1;
+			while (NumBytes < 8 && Size >= (1ull << (7 * NumBytes)) - 1)
+			{
+				NumBytes++;
+			}
+		}
+		Size |= 1ull << (7 * NumBytes);
+		for (int32 Index = NumBytes - 1; Index >= 0; Index--)
+		{
+			Out.Add((uint8)(Size >> (Index * 8)));
+		}
+	}
+
+	void WriteElement(TArray<uint8>& Out, uint32 Id, const TArray<uint8>& Payload)
+	{
+		WriteId(Out, Id);
+		WriteSize(Out, Payload.Num());
+		Out.Append(Payload);
+	}
+
+	void WriteUInt(TArray<uint8>& Out, uint32 Id, uint64 Value, int32 NumBytes = 0)
+	{
+		if (NumBytes == 0)
+		{
+			NumBytes = 1;
+			while (NumBytes < 8 && (Value >> (NumBytes * 8)) != 0)
+			{
+				NumBytes++;
+			}
+		}
+		WriteId(Out, Id);
+		WriteSize(Out, NumBytes);
+		for (int32 Index = NumBytes - 1; Index >= 0; Index--)
+		{
+			Out.Add((uint8)(Value >> (Index * 8)));
+		}
+	}
+
+	void WriteDouble(TArray<uint8>& Out, uint32 Id, double Value)
+	{
+		uint64 Bits;
+		FMemory::Memcpy(&Bits, &Value, sizeof(Bits));
+		WriteUInt(Out, Id, Bits, 8);
+	}
+
+	void WriteString(TArray<uint8>& Out, uint32 Id, const FString& Value)
+	{
+		FTCHARToUTF8 Converted(*Value);
+		WriteId(Out, Id);
+		WriteSize(Out, Converted.Length());
+		Out.Append((const uint8*)Converted.Get(), Converted.Length());
+	}
+}
+
+TUniquePtr<FMatroskaWriter> FMatroskaWriter::Create(const FOptions& Options)
+{
+	TUniquePtr<FArchive> Archive(IFileManager::Get().CreateFileWriter(*Options.Filename));
+	if (!Archive.IsValid())
+	{
+		UE_LOG(LookingGlassLogGame, Error, TEXT("Unable to create video file %s"), *Options.Filename);
+		return nullptr;
+	}
+
+	TUniquePtr<FMatroskaWriter> Writer(new FMatroskaWriter(Options, MoveTemp(Archive)));
+	Writer->WriteHeaders();
+	return Writer;
+}
+
+FMatroskaWriter::FMatroskaWriter(const FOptions& InOptions, TUniquePtr<FArchive>&& InArchive)
+	: Options(InOptions)
+	, Archive(MoveTemp(InArchive))
+{
+}
+
+FMatroskaWriter::~FMatroskaWriter()
+{
+	Finalize();
+}
+
+int64 FMatroskaWriter::GetFrameTimestamp(int32 FrameIndex) const
+{
+	return FMath::RoundToInt64(Options.FrameRate.AsSeconds(FFrameTime(FrameIndex)) * 1000.0);
+}
+
+void FMatroskaWriter::WriteHeaders()
+{
+	TArray<uint8> Data;
+
+	TArray<uint8> Header;
+	WriteUInt(Header, EBML_Version, 1);
+	WriteUInt(Header, EBML_ReadVersion, 1);
+	WriteUInt(Header, EBML_MaxIDLength, 4);
+	WriteUInt(Header, EBML_MaxSizeLength, 8);
+	WriteString(Header, EBML_DocType, TEXT("matroska"));
+	WriteUInt(Header, EBML_DocTypeVersion, 4);
+	WriteUInt(Header, EBML_DocTypeReadVersion, 2);
+	WriteElement(Data, EBML_Header, Header);
+
+	// Segment of unknown size, which is valid until the real size is written by Finalize()
+	WriteId(Data, MKV_Segment);
+	SegmentSizeOffset = Data.Num();
+	WriteSize(Data, 0xFFFFFFFFFFFFFFull, 8);
+	SegmentDataOffset = Data.Num();
+
+	// Space for the seek head
+	SeekHeadOffset = Data.Num();
+	WriteId(Data, EBML_Void);
+	WriteSize(Data, SeekHeadReservedSize - 2, 1);
+	Data.AddZeroed(SeekHeadReservedSize - 2);
+
+	InfoPosition = Data.Num() - SegmentDataOffset;
+	TArray<uint8> Info;
+	WriteUInt(Info, MKV_TimestampScale, TimestampScale);
+	WriteString(Info, MKV_MuxingApp, TEXT("LookingGlass"));
+	WriteString(Info, MKV_WritingApp, TEXT("LookingGlass Unreal plugin"));
+	if (!Options.Title.IsEmpty())
+	{
+		WriteString(Info, MKV_Title, Options.Title);
+	}
+	// Duration is the last element, its value is patched when finalizing
+	WriteDouble(Info, MKV_Duration, 0.0);
+	WriteElement(Data, MKV_Info, Info);
+	DurationOffset = Data.Num() - 8;
+
+	TracksPosition = Data.Num() - SegmentDataOffset;
+	TArray<uint8> Video;
+	WriteUInt(Video, MKV_PixelWidth, Options.Width);
+	WriteUInt(Video, MKV_PixelHeight, Options.Height);
+
+	TArray<uint8> Track;
+	WriteUInt(Track, MKV_TrackNumber, 1);
+	WriteUInt(Track, MKV_TrackUID, 1);
+	WriteUInt(Track, MKV_TrackType, 1); // video
+	WriteUInt(Track, MKV_FlagLacing, 0);
+	WriteString(Track, MKV_CodecID, TEXT("V_MJPEG"));
+	if (Options.FrameRate.IsValid())
+	{
+		WriteUInt(Track, MKV_DefaultDuration, (uint64)FMath::RoundToInt64(Options.FrameRate.AsInterval() * 1e9));
+	}
+	WriteElement(Track, MKV_Video, Video);
+
+	TArray<uint8> Tracks;
+	WriteElement(Tracks, MKV_TrackEntry, Track);
+	WriteElement(Data, MKV_Tracks, Tracks);
+
+	Archive->Serialize(Data.GetData(), Data.Num());
+}
+
+void FMatroskaWriter::WriteFrame(const TArray64<uint8>& JpegData, int32 FrameIndex)
+{
+	if (!Archive.IsValid())
+	{
+		return;
+	}
+
+	// Every frame is a key frame, so it gets its own cluster and cue point
+	const int64 Timestamp = GetFrameTimestamp(FrameIndex);
+	const int64 ClusterPosition = Archive->Tell() - SegmentDataOffset;
+	CuePoints.Emplace(Timestamp, ClusterPosition);
+	LastTimestamp = FMath::Max(LastTimestamp, Timestamp);
+
+	// SimpleBlock: track number, timestamp relative to the cluster, flags
+	TArray<uint8> BlockHeader;
+	WriteSize(BlockHeader, 1);
+	BlockHeader.Add(0);
+	BlockHeader.Add(0);
+	BlockHeader.Add(0x80);
+
+	TArray<uint8> ClusterHeader;
+	WriteUInt(ClusterHeader, MKV_Timestamp, Timestamp);
+	WriteId(ClusterHeader, MKV_SimpleBlock);
+	WriteSize(ClusterHeader, BlockHeader.Num() + JpegData.Num(), 8);
+	ClusterHeader.Append(BlockHeader);
+
+	TArray<uint8> Data;
+	WriteId(Data, MKV_Cluster);
+	WriteSize(Data, ClusterHeader.Num() + JpegData.Num(), 8);
+	Data.Append(ClusterHeader);
+
+	Archive->Serialize(Data.GetData(), Data.Num());
+	Archive->Serialize(const_cast<uint8*>(JpegData.GetData()), JpegData.Num());
+}
+
+void FMatroskaWriter::Finalize()
+{
+	if (!Archive.IsValid())
+	{
+		return;
+	}
+
+	// Cues, for seeking
+	const int64 CuesPosition = Archive->Tell() - SegmentDataOffset;
+	TArray<uint8> Cues;
+	for (const TPair<int64, int64>& CuePoint : CuePoints)
+	{
+		TArray<uint8> Positions;
+		WriteUInt(Positions, MKV_CueTrack, 1);
+		WriteUInt(Positions, MKV_CueClusterPosition, CuePoint.Value);
+
+		TArray<uint8> Point;
+		WriteUInt(Point, MKV_CueTime, CuePoint.Key);
+		WriteElement(Point, MKV_CueTrackPositions, Positions);
+
+		WriteElement(Cues, MKV_CuePoint, Point);
+	}
+	TArray<uint8> Data;
+	WriteElement(Data, MKV_Cues, Cues);
+	Archive->Serialize(Data.GetData(), Data.Num());
+
+	const int64 EndOffset = Archive->Tell();
+
+	// Segment size
+	Data.Reset();
+	WriteSize(Data, EndOffset - SegmentDataOffset, 8);
+	Archive->Seek(SegmentSizeOffset);
+	Archive->Serialize(Data.GetData(), Data.Num());
+
+	// Seek head, in the reserved space. The rest of the space stays void.
+	TArray<uint8> SeekHead;
+	auto AddSeek = [&SeekHead](uint32 Id, int64 Position)
+	{
+		TArray<uint8> IdData;
+		WriteId(IdData, Id);
+
+		TArray<uint8> Seek;
+		WriteElement(Seek, MKV_SeekID, IdData);
+		WriteUInt(Seek, MKV_SeekPosition, Position, 8);
+		WriteElement(SeekHead, MKV_Seek, Seek);
+	};
+	AddSeek(MKV_Info, InfoPosition);
+	AddSeek(MKV_Tracks, TracksPosition);
+	AddSeek(MKV_Cues, CuesPosition);
+
+	Data.Reset();
+	WriteElement(Data, MKV_SeekHead, SeekHead);
+	check(Data.Num() <= SeekHeadReservedSize - 2);
+	WriteId(Data, EBML_Void);
+	WriteSize(Data, SeekHeadReservedSize - Data.Num() - 2, 1);
+	Data.SetNumZeroed(SeekHeadReservedSize);
+	Archive->Seek(SeekHeadOffset);
+	Archive->Serialize(Data.GetData(), Data.Num());
+
+	// Duration: timestamp of the end of the last frame
+	Data.Reset();
+	const double Duration = LastTimestamp + (Options.FrameRate.IsValid() ? Options.FrameRate.AsInterval() * 1000.0 : 0.0);
+	uint64 DurationBits;
+	FMemory::Memcpy(&DurationBits, &Duration, sizeof(DurationBits));
+	for (int32 Index = 7; Index >= 0; Index--)
+	{
+		Data.Add((uint8)(DurationBits >> (Index * 8)));
+	}
+	Archive->Seek(DurationOffset);
+	Archive->Serialize(Data.GetData(), Data.Num());
+
+	Archive->Seek(EndOffset);
+	Archive->Close();
+	Archive.Reset();
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Misc/FrameRate.h"
+
+class FArchive;
+
+namespace LookingGlass
+{
+	/**
+	 * @class	FMatroskaWriter
+	 *
+	 * @brief	Streaming writer of Matroska (.mkv) files with a single Motion JPEG video track. Frames are appended
+	 * 			as they arrive, each one in its own cluster, so a file which wasn't finalized is still playable.
+	 * 			Finalize() writes the seek index and patches the segment size and duration.
+	 */
+
+	class FMatroskaWriter
+	{
+	public:
+		struct FOptions
+		{
+			FString Filename;
+			int32 Width = 0;
+			int32 Height = 0;
+			FFrameRate FrameRate;
+			// Stored in the segment info, e.g. quilt settings of the video
+			FString Title;
+		};
+
+		/**
+		 * @fn	static TUniquePtr<FMatroskaWriter> FMatroskaWriter::Create(const FOptions& Options);
+		 *
+		 * @brief	Creates the file and writes the headers
+		 *
+		 * @param	Options	Video options.
+		 *
+		 * @returns	The writer, or null if the file couldn't be created.
+		 */
+
+		static TUniquePtr<FMatroskaWriter> Create(const FOptions& Options);
+
+		~FMatroskaWriter();
+
+		/**
+		 * @fn	void FMatroskaWriter::WriteFrame(const TArray64<uint8>& JpegData, int32 FrameIndex);
+		 *
+		 * @brief	Appends a JPEG compressed frame
+		 *
+		 * @param	JpegData  	Compressed frame.
+		 * @param	FrameIndex	Index of the frame since beginning of the video, determines its timestamp.
+		 */
+
+		void WriteFrame(const TArray64<uint8>& JpegData, int32 FrameIndex);
+
+		// Write the index and close the file. Called automatically on destruction.
+		void Finalize();
+
+		const FOptions& GetOptions() const
+		{
+			return Options;
+		}
+
+		bool IsCapturing() const
+		{
+			return Archive.IsValid();
+		}
+
+	private:
+		FMatroskaWriter(const FOptions& InOptions, TUniquePtr<FArchive>&& InArchive);
+
+		void WriteHeaders();
+
+		// Time in milliseconds, which is the timestamp scale of the file
+		int64 GetFrameTimestamp(int32 FrameIndex) const;
+
+		FOptions Options;
+
+		TUniquePtr<FArchive> Archive;
+
+		// Offsets in the file: data of the segment, its size field, space reserved for the seek head, and duration value
+		int64 SegmentDataOffset = 0;
+		int64 SegmentSizeOffset = 0;
+		int64 SeekHeadOffset = 0;
+		int64 DurationOffset = 0;
+		// Offsets of Info and Tracks relative to the segment data, for the seek head
+		int64 InfoPosition = 0;
+		int64 TracksPosition = 0;
+
+		// Timestamps and cluster positions of written frames, for cues
+		TArray<TPair<int64, int64>> CuePoints;
+
+		int64 LastTimestamp = 0;
+	};
+}
@@ -9,8 +9,16 @@
 #include "MovieSceneCaptureModule.h"
 #include "MovieSceneCapture.h"
 #include "AVIWriter.h"
+#include "Async/Async.h"
+#include "Misc/Paths.h"
 
 #include "Render/LookingGlassViewportClient.h"
+#include "Render/LookingGlassImagePixelData.h"
+#include "Sequencer/LookingGlassMatroskaWriter.h"
+#include "Misc/LookingGlassImageEncoder.h"
+#include "Misc/LookingGlassHelpers.h"
+#include "Misc/LookingGlassLog.h"
+#include "Misc/LookingGlassStats.h"
 #include "Game/LookingGlassSceneCaptureComponent2D.h"
 
 struct FImageFrameData : IFramePayload
@@ -18,6 +26,24 @@ struct FImageFrameData : IFramePayload
 	FString Filename;
 };
 
+// Attached to image data of a frame passed to the write queue; destroyed when the image has been written
+struct FEncodedFramePayload : IImagePixelDataPayload
+{
+	FEncodedFramePayload(const FLookingGlassCaptureQueueStateRef& InQueueState)
+		: QueueState(InQueueState)
+	{
+		QueueState->EncodingFrameCount.Increment();
+	}
+
+	virtual ~FEncodedFramePayload()
+	{
+		QueueState->EncodingFrameCount.Decrement();
+		QueueState->EncodedFrameCount.Increment();
+	}
+
+	FLookingGlassCaptureQueueStateRef QueueState;
+};
+
 bool ULookingGlassProtocol::HasFinishedProcessingImpl() const
 {
 	FScopeLock Lock(&CapturedFramesMutex);
@@ -41,8 +67,35 @@ bool ULookingGlassProtocol::SetupImpl()
 	return true;
 }
 
+int32 ULookingGlassProtocol::GetQueuedFrameCount() const
+{
+	FScopeLock Lock(&CapturedFramesMutex);
+	return CapturedFrames.Num() + QueueState->EncodingFrameCount.GetValue();
+}
+
 void ULookingGlassProtocol::CaptureFrameImpl(const FFrameMetrics& FrameMetrics)
 {
+	if (GetQueuedFrameCount() >= MaxQueuedFrames)
+	{
+		if (QueueFullPolicy == ELookingGlassCaptureQueuePolicy::DropFrames)
+		{
+			// The frame won't be read back for this capture
+			INC_DWORD_STAT(STAT_CaptureDroppedFrames);
+			UE_LOG(LookingGlassLogGame, Verbose, TEXT("Capture queue is full, dropping frame %d"), FrameMetrics.FrameNumber);
+			return;
+		}
+
+		// Throttle: hold the game thread, so Sequencer won't advance, until the encoder frees some room
+		SCOPE_CYCLE_COUNTER(STAT_CaptureStall_GameThread);
+		const double StartTime = FPlatformTime::Seconds();
+		ProcessCapturedFrames();
+		while (GetQueuedFrameCount() >= MaxQueuedFrames)
+		{
+			FPlatformProcess::Sleep(0.001f);
+		}
+		SET_FLOAT_STAT(STAT_CaptureStallTime, (FPlatformTime::Seconds() - StartTime) * 1000.0);
+	}
+
 	OutstandingFrameCount.Increment();
 	//todo: in a case OnFrameReady will be called from render thread, should use ENQUEUE_RENDER_COMMAND (see FFrameGrabber::CaptureThisFrame)
 	check(IsInGameThread());
@@ -50,6 +103,12 @@ void ULookingGlassProtocol::CaptureFrameImpl(const FFrameMetrics& FrameMetrics)
 }
 
 void ULookingGlassProtocol::TickImpl()
+{
+	ProcessCapturedFrames();
+	UpdateQueueStats();
+}
+
+void ULookingGlassProtocol::ProcessCapturedFrames()
 {
 	TArray<FCapturedFrameData> Frames;
 
@@ -67,14 +126,36 @@ void ULookingGlassProtocol::TickImpl()
 	}
 }
 
+void ULookingGlassProtocol::UpdateQueueStats()
+{
+	SET_DWORD_STAT(STAT_CaptureQueueDepth, GetQueuedFrameCount() + OutstandingFrameCount.GetValue());
+
+	// Encoder throughput, averaged over one second
+	const double Now = FPlatformTime::Seconds();
+	if (LastThroughputTime == 0)
+	{
+		LastThroughputTime = Now;
+		LastEncodedFrameCount = QueueState->EncodedFrameCount.GetValue();
+	}
+	else if (Now - LastThroughputTime >= 1.0)
+	{
+		const int32 EncodedFrameCount = QueueState->EncodedFrameCount.GetValue();
+		SET_FLOAT_STAT(STAT_CaptureEncodeThroughput, (EncodedFrameCount - LastEncodedFrameCount) / (Now - LastThroughputTime));
+		LastThroughputTime = Now;
+		LastEncodedFrameCount = EncodedFrameCount;
+	}
+}
+
 void ULookingGlassProtocol::FinalizeImpl()
 {
 	FLookingGlassViewportClient::OnLookingGlassFrameReady.RemoveAll(this);
 	// Unhook global resolution
 	ULookingGlassSceneCaptureComponent2D::ResetGlobalTilingProperties();
+	// Don't keep frame buffers of the finished capture
+	FLookingGlassPixelBufferPool::Get().Trim();
 }
 
-void ULookingGlassProtocol::OnFrameReady(const TArray<FColor>& Bitmap, int32 Width, int32 Height)
+void ULookingGlassProtocol::OnFrameReady(const FLookingGlassPixelBufferRef& Buffer)
 {
 	if (PendingFramePayloads.Num() == 0)
 	{
@@ -85,8 +166,9 @@ void ULookingGlassProtocol::OnFrameReady(const TArray<FColor>& Bitmap, int32 Wid
 	FFramePayloadPtr Payload = PendingFramePayloads[0];
 	PendingFramePayloads.RemoveAt(0, 1, EAllowShrinking::Yes);
 
-	FCapturedFrameData FrameData(FIntPoint(Width, Height), Payload);
-	FrameData.ColorBuffer = Bitmap;
+	// Keep a reference to the buffer, pixels are not copied
+	FCapturedFrameData FrameData(Buffer->Size, Payload);
+	FrameData.ColorBuffer = Buffer;
 
 	// Store data
 	FScopeLock Lock(&CapturedFramesMutex);
@@ -265,20 +347,13 @@ FFramePayloadPtr ULookingGlassProtocol_PNG::GetFramePayload(const FFrameMetrics&
 
 void ULookingGlassProtocol_PNG::ProcessFrame(FCapturedFrameData Frame)
 {
-	check(Frame.ColorBuffer.Num() >= Frame.BufferSize.X * Frame.BufferSize.Y);
+	check(Frame.ColorBuffer.IsValid() && Frame.ColorBuffer->Pixels.Num() >= (int64)Frame.BufferSize.X * Frame.BufferSize.Y);
 
 	TUniquePtr<FImageWriteTask> ImageTask = MakeUnique<FImageWriteTask>();
 
-	// Move the color buffer into a raw image data container that we can pass to the write queue
-	ImageTask->PixelData = MakeUnique<TImagePixelData<FColor>>(Frame.BufferSize, TArray64<FColor>(MoveTemp(Frame.ColorBuffer)));
-	//todo: can remove #if 0...#endif later if we won't need any other output image formats
-#if 0
-	if (Format == EImageFormat::PNG)
-#endif
-	{
-		// Always write full alpha for PNGs
-		ImageTask->PixelPreProcessors.Add(TAsyncAlphaWrite<FColor>(255));
-	}
+	// Pass the pooled buffer to the write queue by reference. Alpha is already full, it is written during readback.
+	// The payload tracks the frame in the capture queue until the image is written.
+	ImageTask->PixelData = MakeUnique<FLookingGlassImagePixelData>(Frame.ColorBuffer.ToSharedRef(), MakeShared<FEncodedFramePayload, ESPMode::ThreadSafe>(QueueState));
 
 #if 0
 	switch (Format)
@@ -338,7 +413,8 @@ void ULookingGlassProtocol_AVI::ProcessFrame(FCapturedFrameData Frame)
 		FVideoFrameData* Payload = Frame.GetPayload<FVideoFrameData>();
 
 		AVIWriters[WriterIndex]->DropFrames(Payload->Metrics.NumDroppedFrames);
-		AVIWriters[WriterIndex]->Update(Payload->Metrics.TotalElapsedTime, MoveTemp(Frame.ColorBuffer));
+		// AVI writer owns its frame data, so this is the only place where the frame is copied
+		AVIWriters[WriterIndex]->Update(Payload->Metrics.TotalElapsedTime, TArray<FColor>(Frame.ColorBuffer->Pixels.GetData(), (int32)Frame.ColorBuffer->Pixels.Num()));
 
 		// Finalize previous writers if necessary
 		for (int32 Index = 0; Index < WriterIndex; ++Index)
@@ -423,6 +499,163 @@ void ULookingGlassProtocol_AVI::ConditionallyCreateWriter(int32 Width, int32 Hei
 		Options.CompressionQuality = FMath::Clamp<float>(Options.CompressionQuality.GetValue(), 0.f, 1.f);
 	}
 
-	AVIWriters.Emplace(FAVIWriter::CreateInstance(Options));
+	// The engine has an AVI writer on Windows and Mac only
+	FAVIWriter* Writer = FAVIWriter::CreateInstance(Options);
+	if (Writer == nullptr)
+	{
+		UE_LOG(LookingGlassLogGame, Error, TEXT("AVI capture isn't supported on this platform"));
+		return;
+	}
+
+	AVIWriters.Emplace(Writer);
 	AVIWriters.Last()->Initialize();
 }
+
+
+struct FMKVFrameData : IFramePayload
+{
+	FFrameMetrics Metrics;
+	FString Filename;
+};
+
+bool ULookingGlassProtocol_MKV::SetupImpl()
+{
+	FParse::Value( FCommandLine::Get(), TEXT( "-MovieQuality=" ), CompressionQuality );
+	CompressionQuality = FMath::Clamp<int32>(CompressionQuality, 1, 100);
+
+	return Super::SetupImpl();
+}
+
+FFramePayloadPtr ULookingGlassProtocol_MKV::GetFramePayload(const FFrameMetrics& FrameMetrics)
+{
+	TSharedRef<FMKVFrameData, ESPMode::ThreadSafe> FrameData = MakeShareable(new FMKVFrameData);
+	FrameData->Metrics = FrameMetrics;
+
+	// The name is resolved now, because the quilt settings of the current shot are known only at this time
+	FString Extension = TEXT(".mkv");
+	TWeakObjectPtr<ULookingGlassSceneCaptureComponent2D> LookingGlassCaptureComponent = LookingGlass::GetGameLookingGlassCaptureComponent();
+	if (bAddQuiltSettingsSuffix && LookingGlassCaptureComponent.IsValid())
+	{
+		const FLookingGlassTilingQuality& TilingValues = LookingGlassCaptureComponent->GetTilingValues();
+		Extension = FString::Printf(TEXT("_qs%dx%da%.2f.mkv"), TilingValues.TilesX, TilingValues.TilesY, LookingGlassCaptureComponent->GetAspectRatio());
+	}
+	FrameData->Filename = GenerateFilenameImpl(FFrameMetrics(), *Extension);
+
+	return FrameData;
+}
+
+void ULookingGlassProtocol_MKV::ProcessFrame(FCapturedFrameData Frame)
+{
+	check(Frame.ColorBuffer.IsValid() && Frame.ColorBuffer->Pixels.Num() >= (int64)Frame.BufferSize.X * Frame.BufferSize.Y);
+
+	FMKVFrameData* Payload = Frame.GetPayload<FMKVFrameData>();
+
+	FPendingFrame& PendingFrame = PendingFrames.AddDefaulted_GetRef();
+	PendingFrame.Filename = Payload->Filename;
+	PendingFrame.Size = Frame.BufferSize;
+	PendingFrame.FrameNumber = Payload->Metrics.FrameNumber;
+
+	// Frames are encoded concurrently, and every frame is split into strips encoded in parallel. The pixel buffer
+	// goes back to the pool, and the frame leaves the capture queue, as soon as it is compressed.
+	PendingFrame.Data = Async(EAsyncExecution::ThreadPool,
+		[Buffer = Frame.ColorBuffer, Size = Frame.BufferSize, Quality = CompressionQuality, EncodedPayload = MakeShared<FEncodedFramePayload, ESPMode::ThreadSafe>(QueueState)]() mutable
+		{
+			TArray64<uint8> Data;
+			if (!LookingGlass::ImageEncoder::EncodeJPEG(Buffer->Pixels.GetData(), Size.X, Size.Y, Quality, Data))
+			{
+				Data.Empty();
+			}
+			Buffer.Reset();
+			EncodedPayload.Reset();
+			return Data;
+		});
+}
+
+void ULookingGlassProtocol_MKV::TickImpl()
+{
+	Super::TickImpl();
+
+	WriteEncodedFrames(false);
+}
+
+void ULookingGlassProtocol_MKV::WriteEncodedFrames(bool bWait)
+{
+	int32 NumWritten = 0;
+	for (; NumWritten < PendingFrames.Num(); NumWritten++)
+	{
+		FPendingFrame& Frame = PendingFrames[NumWritten];
+		if (!bWait && !Frame.Data.IsReady())
+		{
+			break;
+		}
+
+		const TArray64<uint8>& Data = Frame.Data.Get();
+		if (Data.Num() == 0)
+		{
+			UE_LOG(LookingGlassLogGame, Warning, TEXT("Unable to encode frame %d of %s"), Frame.FrameNumber, *Frame.Filename);
+			continue;
+		}
+
+		ConditionallyCreateWriter(Frame);
+		if (Writer.IsValid())
+		{
+			Writer->WriteFrame(Data, Frame.FrameNumber - FirstFrameNumber);
+		}
+	}
+
+	PendingFrames.RemoveAt(0, NumWritten);
+}
+
+void ULookingGlassProtocol_MKV::ConditionallyCreateWriter(const FPendingFrame& Frame)
+{
+	if (Writer.IsValid() && Writer->GetOptions().Filename == Frame.Filename && Writer->GetOptions().Width == Frame.Size.X && Writer->GetOptions().Height == Frame.Size.Y)
+	{
+		return;
+	}
+
+	// Finalize the previous video
+	Writer.Reset();
+
+	EnsureFileWritableImpl(Frame.Filename);
+
+	LookingGlass::FMatroskaWriter::FOptions Options;
+	Options.Filename = Frame.Filename;
+	Options.Width = Frame.Size.X;
+	Options.Height = Frame.Size.Y;
+	Options.FrameRate = CaptureHost->GetCaptureFrameRate();
+	// Keep quilt settings in the file even when it is renamed
+	Options.Title = FPaths::GetBaseFilename(Frame.Filename);
+
+	TUniquePtr<LookingGlass::FMatroskaWriter> NewWriter = LookingGlass::FMatroskaWriter::Create(Options);
+	if (NewWriter.IsValid())
+	{
+		Writer = MakeShareable(NewWriter.Release());
+	}
+	FirstFrameNumber = Frame.FrameNumber;
+	WrittenFilenames.AddUnique(Frame.Filename);
+}
+
+void ULookingGlassProtocol_MKV::FinalizeImpl()
+{
+	WriteEncodedFrames(true);
+	Writer.Reset();
+	WrittenFilenames.Empty();
+
+	Super::FinalizeImpl();
+}
+
+bool ULookingGlassProtocol_MKV::CanWriteToFileImpl(const TCHAR* InFilename, bool bOverwriteExisting) const
+{
+	// Same as for AVI: we can always write to a file which we're already writing to
+	if (!bOverwriteExisting)
+	{
+		if (WrittenFilenames.Contains(InFilename))
+		{
+			return true;
+		}
+
+		return IFileManager::Get().FileSize(InFilename) == -1;
+	}
+
+	return true;
+}
@@ -5,6 +5,8 @@
 
 #include "CoreMinimal.h"
 #include "Components/SceneCaptureComponent2D.h"
+#include "Curves/CurveFloat.h"
+#include "PixelFormat.h"
 
 #include "LookingGlassSettings.h"
 
@@ -28,8 +30,18 @@ public:
 
 	~FLookingGlassRenderingConfig();
 
-	/** Init should be called separately, because we do not control construction of UObject directly */
-	void Init(UObject* Parent, uint32 InMinTextureIndex, uint32 InMaxTextureIndex, const FIntPoint& InViewSize);
+	/**
+	 * Init should be called separately, because we do not control construction of UObject directly.
+	 * InQuiltViewIndices are indices of the rendered views in the quilt, in ascending order.
+	 * When bAllocateRenderTarget is false, views are rendered into an external texture (the quilt) and no
+	 * intermediate render target is used. Otherwise it is leased from the runtime's render target pool by PrepareRT().
+	 */
+	void Init(TArray<int32>&& InQuiltViewIndices, const FIntPoint& InViewSize, bool bAllocateRenderTarget = true, EPixelFormat InFormat = PF_A16B16G16R16);
+
+	/** Capture scene depth of the views, for view synthesis */
+	void EnableDepthCapture();
+
+	const TSharedPtr<class FLookingGlassDepthCapture, ESPMode::ThreadSafe>& GetDepthCapture() const { return DepthCapture; }
 
 	void AddReferencedObjects(FReferenceCollector& Collector);
 
@@ -43,14 +55,25 @@ public:
 
 	int32 GetFirstViewIndex() const { return FirstViewIndex; }
 
+	/** Index of the quilt tile which holds the view ViewIndex of this config */
+	int32 GetQuiltViewIndex(int32 ViewIndex) const { return QuiltViewIndices[ViewIndex]; }
+
+	const TArray<int32>& GetQuiltViewIndices() const { return QuiltViewIndices; }
+
 	int32 GetViewRows() const { return ViewRows; }
 
 	int32 GetViewColumns() const { return ViewColumns; }
 
-	// Resize the rendering target to match our needs
-	//todo: resize it back to 1x1 when rendering stops (call ReduceMemoryUse)
+	/** Renders the view ViewIndex into the top-left part of its rectangle, which is upsampled by the quilt copy */
+	void SetViewResolutionScale(int32 ViewIndex, float Scale);
+
+	/** Rendered part of every view rectangle, in both dimensions */
+	const TArray<FVector2f>& GetViewScales() const { return ViewScales; }
+
+	// Lease the rendering target from the pool, if it wasn't leased yet
 	void PrepareRT();
 
+	// Return the rendering target to the pool until the next PrepareRT()
 	void ReduceMemoryUse();
 
 	void Release();
@@ -58,10 +81,19 @@ public:
 	/** Maximal number of views rendered with a single draw call */
 	static constexpr uint8 MaxView = 8;
 
+	/** Converts the user facing format setting to the pixel format of render targets */
+	static EPixelFormat GetPixelFormat(ELookingGlassPixelFormat PixelFormat);
+
+	/** Arranges NumViews views into rows and columns of a render target, wrapping rows which exceed GMaxTextureDimensions */
+	static void CalculateTextureLayout(const FIntPoint& ViewSize, int32 NumViews, int32& OutViewRows, int32& OutViewColumns);
+
 	static void CalculateViewRect(FIntRect& Rect, const FIntPoint& Size, int32 ViewRows, int32 ViewColumns, int32 ViewIndex);
 
 	static void CalculateViewRect(float& U, float& V, float& SizeU, float& SizeV, int32 ViewRows, int32 ViewColumns, int32 ViewCount, int32 ViewIndex);
 
+	/** Computes rectangle of the quilt tile which holds the view ViewIndex, in quilt texture pixels */
+	static void CalculateQuiltTileRect(FIntRect& Rect, const FLookingGlassTilingQuality& TilingValues, ELookingGlassQuiltOrder QuiltOrder, int32 ViewIndex);
+
 private:
 
 #if (ENGINE_MAJOR_VERSION < 5) || (ENGINE_MAJOR_VERSION == 5 && ENGINE_MINOR_VERSION < 6)
@@ -71,14 +103,32 @@ private:
 	TObjectPtr<UTextureRenderTarget2D> RenderTarget;
 #endif
 
+	// False when views are rendered into an external texture
+	bool bUseRenderTarget;
+
 	// Same as ViewInfoArr.Num(). Number of views is limited either by GMaxTextureDimensions or MaxViews.
 	uint32 NumViews;
 
 	int32 FirstViewIndex;
 
+	// Quilt tile of every view. Views are consecutive, unless some views are synthesized instead of being rendered.
+	TArray<int32> QuiltViewIndices;
+
+	// Scene depth of the rendered views, when used for view synthesis
+	TSharedPtr<class FLookingGlassDepthCapture, ESPMode::ThreadSafe> DepthCapture;
+
 	// Size of RenderTarget used for rendering
 	FIntPoint TextureSize;
 
+	// Full size of a single view
+	FIntPoint ViewSize;
+
+	// Rendered part of every view, see SetViewResolutionScale()
+	TArray<FVector2f> ViewScales;
+
+	// Pixel format of RenderTarget
+	EPixelFormat Format;
+
 	TArray<FSceneCaptureViewInfo> ViewInfoArr;
 
 	int32 ViewRows;
@@ -94,25 +144,92 @@ struct FLookingGlassRenderingConfigs
 	FLookingGlassRenderingConfigs()
 	{}
 
-	FLookingGlassRenderingConfigs(UObject* InOwner)
-		: Owner(InOwner)
-	{}
-
-	// The outer object which is used for holding all render targets
-	UObject* Owner;
-
 	TArray<FLookingGlassRenderingConfig> Configs;
 
 	// Recent TilingValues which were used for RebuildRenderConfigs
 	FLookingGlassTilingQuality CachedTilingValues;
 
-	void Build(const FLookingGlassTilingQuality& TilingValues, bool bSingleViewMode);
+	// Recent direct-to-quilt mode which was used for RebuildRenderConfigs
+	bool bCachedDirectToQuilt = false;
+
+	// Recent pixel format which was used for RebuildRenderConfigs
+	EPixelFormat CachedFormat = PF_Unknown;
+
+	// Recent view synthesis mode which was used for RebuildRenderConfigs
+	bool bCachedSynthesis = false;
+	int32 CachedSynthesisStep = 1;
+
+	// Recent number of amortized rendering steps which was used for RebuildRenderConfigs
+	int32 CachedAmortizationSteps = 1;
+
+	// Set when configs were rebuilt, so their render targets have no views yet
+	bool bNeedsFullRefresh = true;
+
+	// Number of views rendered at once and estimated memory of a single render, chosen by the recent Build()
+	int32 ViewBatchSize = 0;
+	float EstimatedMemoryMB = 0.0f;
+
+	// Resolution of rendered views relative to quilt tiles. Changing it doesn't rebuild configs, views are rendered into
+	// a part of their render target area and upsampled by the quilt copy.
+	float RenderScale = 1.0f;
+
+	// With bMultiView, all views are placed into a single config. This is possible only when rendering directly to the quilt.
+	// A positive VRAMBudgetMB selects the largest batch which fits the budget, and bSingleViewMode is ignored.
+	// With SynthesisStep above 1, only every SynthesisStep-th view and the last one are rendered, with depth.
+	// With AmortizationSteps above 1, views are split into at least that many configs, so a part of them could be refreshed every frame.
+	// InRenderScale below 1 is applied to views of the intermediate render targets, see RenderScale.
+	void Build(const FLookingGlassTilingQuality& TilingValues, bool bSingleViewMode, bool bDirectToQuilt = false, bool bMultiView = false, int32 VRAMBudgetMB = 0,
+		EPixelFormat Format = PF_A16B16G16R16, int32 SynthesisStep = 1, int32 AmortizationSteps = 1, float InRenderScale = 1.0f);
+
+	/** Quilt indices of the views which are rendered when every SynthesisStep-th view is rendered */
+	static void GetRenderedViews(int32 NumTiles, int32 SynthesisStep, TArray<int32>& OutViews);
+
+	bool IsUsingViewSynthesis() const { return bCachedSynthesis; }
+
+	/**
+	 * @fn	static float FLookingGlassRenderingConfigs::EstimateMemoryMB(const FIntPoint& ViewSize, EPixelFormat Format, int32 NumViews);
+	 *
+	 * @brief	Estimates GPU memory used for rendering a batch of views: scene textures and the intermediate render target.
+	 * 			Both are sized to the batch layout. See EstimateDirectMemoryMB() for direct-to-quilt mode.
+	 *
+	 * @param	ViewSize	Size of a single view.
+	 * @param	Format  	Pixel format of the intermediate render target.
+	 * @param	NumViews	Number of views rendered at once.
+	 *
+	 * @returns	Estimated memory in megabytes.
+	 */
+
+	static float EstimateMemoryMB(const FIntPoint& ViewSize, EPixelFormat Format, int32 NumViews);
+
+	/** Returns the largest number of views, from 1 to MaxViewCount, which could be rendered at once within BudgetMB */
+	static int32 PlanViewBatchSize(const FIntPoint& ViewSize, EPixelFormat Format, int32 MaxViewCount, float BudgetMB);
+
+	/**
+	 * Estimates scene texture memory of the largest render when RenderedViews are rendered in place, at their quilt tiles,
+	 * in batches of BatchSize views. Scene textures cover the quilt from its origin to the furthest tile of a batch.
+	 */
+	static float EstimateDirectMemoryMB(const FLookingGlassTilingQuality& TilingValues, ELookingGlassQuiltOrder QuiltOrder, const TArray<int32>& RenderedViews, int32 BatchSize);
+
+	/**
+	 * Direct-to-quilt counterpart of PlanViewBatchSize(). The furthest tile decides the memory of a render, so a smaller
+	 * batch rarely helps; when nothing fits BudgetMB, the batch with the lowest estimate is used.
+	 */
+	static int32 PlanDirectViewBatchSize(const FLookingGlassTilingQuality& TilingValues, ELookingGlassQuiltOrder QuiltOrder, const TArray<int32>& RenderedViews, int32 MaxViewCount, float BudgetMB);
 
 	void Release()
 	{
 		Configs.Empty();
 	}
 
+	// Return render targets of all configs to the pool, they are leased again when rendering resumes
+	void ReduceMemoryUse()
+	{
+		for (FLookingGlassRenderingConfig& Config : Configs)
+		{
+			Config.ReduceMemoryUse();
+		}
+	}
+
 	void AddReferencedObjects(FReferenceCollector& Collector)
 	{
 		for (FLookingGlassRenderingConfig& Config : Configs)
@@ -175,12 +292,24 @@ public:
 #endif
 	//~ End USceneCaptureComponent Interface
 
-	/** Top-level rendering function for making a hologram picture */
-	void RenderViews();
+	/**
+	 * Top-level rendering function for making a hologram picture. In direct-to-quilt mode the views are
+	 * rendered straight into QuiltRT, otherwise into the intermediate render targets of RenderingConfigs.
+	 */
+	void RenderViews(UTextureRenderTarget2D* QuiltRT = nullptr);
 
 	/** Top-level rendering function for making a 2D picture */
 	void Render2DView(int32 SizeX = -1, int32 SizeY = -1);
 
+	/** Make the next RenderViews() call render all views, even with amortized rendering. Used for screenshots and recording. */
+	void RequestFullRefresh() { bFullRefreshRequested = true; }
+
+	/** Releases all render targets until the next RenderViews() or Render2DView(). Used when rendering has been idle for a while. */
+	void ReduceMemoryUse();
+
+	/** Time of the recent RenderViews() or Render2DView() call, in FPlatformTime::Seconds() */
+	double GetLastRenderTime() const { return LastRenderTime; }
+
 	// Change current tiling settings and do all the required refresh work
 	void SetTilingProperties(ELookingGlassQualitySettings InTilingQuailty);
 
@@ -207,6 +336,17 @@ public:
 
 	const FLookingGlassRenderingConfigs& GetRenderingConfigs() const { return RenderingConfigs; }
 
+	bool IsRenderingDirectToQuilt() const { return bRenderDirectToQuilt; }
+
+	// View synthesis needs scene depth from the renderer and the batched quilt copy
+	bool IsViewSynthesisEnabled() const;
+
+	// Amortized rendering keeps views in the intermediate render targets between frames
+	bool IsAmortizedRenderingEnabled() const { return bAmortizedRendering && !bRenderDirectToQuilt; }
+
+	/** Horizontal projection offset of the view, in clip space units. Views differ by this offset and the matching camera shift. */
+	float GetViewProjectionOffset(int32 QuiltViewIndex) const;
+
 	static void SetGlobalTilingProperties(ELookingGlassQualitySettings InTilingQuailty);
 
 	static void ResetGlobalTilingProperties();
@@ -229,10 +369,130 @@ public:
 	UPROPERTY(Interp, EditAnywhere, BlueprintReadWrite, Category = "CaptureSettings", meta = (ClampMin = "8.0", ClampMax = "90.0", UIMin = "8.0", UIMax = "90.0"))
 	float FOV = 14.0f;
 
-	// When disabled, the plugin will render 8 pictures at a time. Enable it if you're experiencing issues with rendering (e.g. out of VRAM problem), with a cost of slower performance.
+	// Choose the number of views rendered at once automatically, as many as fit into VRAMBudgetMB
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "TilingSettings")
+	bool bAutoViewBatching = true;
+
+	// GPU memory which could be used by scene textures and render targets of a single render, in megabytes
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "TilingSettings", meta = (EditCondition = "bAutoViewBatching", ClampMin = "16", UIMin = "64", UIMax = "8192"))
+	int32 VRAMBudgetMB = 1024;
+
+	// When disabled, the plugin will render 8 pictures at a time. Enable it if you're experiencing issues with rendering (e.g. out of VRAM problem), with a cost of slower performance.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "TilingSettings", meta = (EditCondition = "!bAutoViewBatching"))
 	bool bSingleViewMode = true;
 
+	// Render every view straight into its quilt tile, without intermediate render targets and the copy-to-quilt pass.
+	// The renderer sizes scene textures to the furthest view of a render, so any render which includes a far tile gets scene
+	// textures nearly as large as the whole quilt (8192x8192 on 8K presets). This is not a memory saving: it trades the
+	// intermediate targets and the copy for quilt sized scene textures. Works best with bSingleViewMode disabled.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "TilingSettings")
+	bool bRenderDirectToQuilt = false;
+
+	// Render all views of the quilt with a single scene renderer instead of batches of up to 8 views. Scene update, visibility
+	// setup, shadow depths and other view-independent work are done once per quilt. Used only with bRenderDirectToQuilt, as
+	// the quilt is the only render target which holds all views. Scene textures cover the whole quilt.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "TilingSettings", meta = (EditCondition = "bRenderDirectToQuilt"))
+	bool bMultiViewRendering = false;
+
+	// Views differ only by a small horizontal offset, so evaluate post process volumes once, for the first view of every
+	// render, and reuse the result for the other views. Disable if the camera sweep crosses post process volume borders.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, AdvancedDisplay, Category = "TilingSettings")
+	bool bShareViewSetup = true;
+
+	// Pixel format of render targets and the quilt. RGBA8 halves memory and bandwidth of FP16 and suits SDR output,
+	// RGB10A2 reduces banding at the same cost, FP16 is needed for HDR capture sources.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "TilingSettings")
+	ELookingGlassPixelFormat PixelFormat = ELookingGlassPixelFormat::RGB10A2;
+
+	// Render only every ViewSynthesisStep-th view and the last one, and synthesize the views between them from color and
+	// depth of their rendered neighbours. Disoccluded areas are filled with the background. Requires batched quilt copy,
+	// not used with bRenderDirectToQuilt.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "TilingSettings", meta = (EditCondition = "!bRenderDirectToQuilt"))
+	bool bViewSynthesis = false;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "TilingSettings", meta = (EditCondition = "bViewSynthesis", ClampMin = "2", ClampMax = "8"))
+	int32 ViewSynthesisStep = 3;
+
+	// Re-render only a part of the views every frame and keep the others from previous frames, cycling through
+	// AmortizedRenderingSteps groups of views. All views are refreshed on camera cuts and when the camera moves faster than
+	// the thresholds. Suits slowly changing content. Not used with bRenderDirectToQuilt.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "TilingSettings", meta = (EditCondition = "!bRenderDirectToQuilt"))
+	bool bAmortizedRendering = false;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "TilingSettings", meta = (EditCondition = "bAmortizedRendering", ClampMin = "2", ClampMax = "8"))
+	int32 AmortizedRenderingSteps = 2;
+
+	// Camera motion per frame in Unreal units (cm) which causes refresh of all views
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, AdvancedDisplay, Category = "TilingSettings", meta = (EditCondition = "bAmortizedRendering", ClampMin = "0"))
+	float AmortizedMotionThreshold = 1.0f;
+
+	// Camera rotation per frame in degrees which causes refresh of all views
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, AdvancedDisplay, Category = "TilingSettings", meta = (EditCondition = "bAmortizedRendering", ClampMin = "0"))
+	float AmortizedRotationThreshold = 0.5f;
+
+	// Experimental: derive the quilt from the calibration of the device instead of rendering the tiling preset. Views are
+	// sized to the resolution the panel shows them with - one pixel per lens across the panel, and the panel height. Their
+	// number is the smallest which keeps the angle between neighbour views within MaxViewAngleStep, limited by the number
+	// of views the slanted lenses could separate. The preset stays the upper bound for both.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, AdvancedDisplay, Category = "TilingSettings")
+	bool bLenticularTiling = false;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, AdvancedDisplay, Category = "TilingSettings", meta = (EditCondition = "bLenticularTiling", ClampMin = "0.1", UIMax = "5.0", Units = "deg"))
+	float MaxViewAngleStep = 1.0f;
+
+	// Render views at resolution given by ViewResolutionCurve, and upsample them when copying to the quilt. Outer views
+	// of a lenticular display contribute less perceived detail than the centre ones. Not used with bRenderDirectToQuilt.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "TilingSettings", meta = (EditCondition = "!bRenderDirectToQuilt"))
+	bool bPerViewResolution = false;
+
+	// Resolution scale of a view (0..1) by its distance from the centre view: 0 is the centre, 1 is the outermost view
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "TilingSettings", meta = (EditCondition = "bPerViewResolution"))
+	FRuntimeFloatCurve ViewResolutionCurve;
+
+	// Lowest resolution scale of a view
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "TilingSettings", meta = (EditCondition = "bPerViewResolution", ClampMin = "0.1", ClampMax = "1.0"))
+	float MinViewResolutionScale = 0.25f;
+
+	// Apply ViewResolutionCurve only as much as needed to hold TargetFrameTimeMS of GPU time
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "TilingSettings", meta = (EditCondition = "bPerViewResolution"))
+	bool bViewResolutionGovernor = false;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "TilingSettings", meta = (EditCondition = "bViewResolutionGovernor", ClampMin = "1.0", UIMax = "100.0"))
+	float TargetFrameTimeMS = 16.6f;
+
+	// How much ViewResolutionCurve is applied, from 0 (full resolution) to 1. Chosen by the governor.
+	UPROPERTY(VisibleInstanceOnly, Transient, BlueprintReadOnly, Category = "TilingSettings")
+	float ViewResolutionStrength = 1.0f;
+
+	// Step between quality levels at runtime to hold TargetFPS. Game thread, rendering thread and GPU times are measured,
+	// the slowest one decides. Quilt layout of the tiling preset is kept, quality levels scale resolution of all views.
+	// With bViewResolutionGovernor, levels step down only when ViewResolutionCurve is fully applied, and step up only when
+	// it's released. Not used with bRenderDirectToQuilt.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "TilingSettings|Quality Governor", meta = (EditCondition = "!bRenderDirectToQuilt"))
+	bool bTilingQualityGovernor = false;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "TilingSettings|Quality Governor", meta = (EditCondition = "bTilingQualityGovernor", ClampMin = "10", UIMax = "120"))
+	float TargetFPS = 60.0f;
+
+	// Resolution scales of quality levels, from the best to the worst
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "TilingSettings|Quality Governor", meta = (EditCondition = "bTilingQualityGovernor"))
+	TArray<float> TilingQualityLevels = { 1.0f, 0.85f, 0.7f, 0.5f };
+
+	// Seconds over the frame budget before stepping to a lower quality level
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, AdvancedDisplay, Category = "TilingSettings|Quality Governor", meta = (EditCondition = "bTilingQualityGovernor", ClampMin = "0"))
+	float QualityDowngradeDelay = 1.0f;
+
+	// Seconds with frame time below QualityUpgradeHeadroom of the budget before stepping to a higher quality level
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, AdvancedDisplay, Category = "TilingSettings|Quality Governor", meta = (EditCondition = "bTilingQualityGovernor", ClampMin = "0"))
+	float QualityUpgradeDelay = 3.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, AdvancedDisplay, Category = "TilingSettings|Quality Governor", meta = (EditCondition = "bTilingQualityGovernor", ClampMin = "0.1", ClampMax = "1.0"))
+	float QualityUpgradeHeadroom = 0.75f;
+
+	// Index in TilingQualityLevels chosen by the governor
+	UPROPERTY(VisibleInstanceOnly, Transient, BlueprintReadOnly, Category = "TilingSettings|Quality Governor")
+	int32 TilingQualityLevel = 0;
+
 	// A static replacement for Quilt image.
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "QuiltSettings")
 	UTexture2D* OverrideQuiltTexture2D = nullptr;
@@ -361,9 +621,50 @@ private:
 	void RebuildRenderConfigs()
 	{
 		TilingValues.Setup();
-		RenderingConfigs.Build(TilingValues, bSingleViewMode);
+		RenderingConfigs.Build(TilingValues, bSingleViewMode, bRenderDirectToQuilt, bMultiViewRendering, bAutoViewBatching ? VRAMBudgetMB : 0,
+			FLookingGlassRenderingConfig::GetPixelFormat(PixelFormat), IsViewSynthesisEnabled() ? ViewSynthesisStep : 1,
+			IsAmortizedRenderingEnabled() ? AmortizedRenderingSteps : 1, GetTilingQualityScale());
 	}
 
+	// Resolution scale of the current quality level
+	float GetTilingQualityScale() const;
+
+	// Replaces the preset with the tiling derived from device calibration, see bLenticularTiling. Returns false when
+	// the calibration has no lenticular data.
+	bool ApplyLenticularTiling(FLookingGlassTilingQuality& InOutTilingValues) const;
+
+	// Measures frame time and steps TilingQualityLevel, with hysteresis
+	void UpdateTilingQualityGovernor();
+
+	// Governor state: smoothed frame time and how long it has been over or well below the budget
+	float AverageFrameTimeMS = 0.0f;
+	float OverBudgetTime = 0.0f;
+	float UnderBudgetTime = 0.0f;
+
+	// Checks whether all views should be rendered this frame with amortized rendering, and remembers the camera state
+	bool ShouldRefreshAllViews();
+
+	// Returns TextureTarget2DRendering to the render target pool
+	void Release2DRenderTarget();
+
+	// Resolution scale of a view at CurrentViewLerp (-0.5..0.5)
+	float GetViewResolutionScale(float CurrentViewLerp) const;
+
+	// Adjusts ViewResolutionStrength by the recent GPU frame time
+	void UpdateViewResolutionGovernor();
+
+	// Smoothed GPU frame time, for the governor
+	float AverageGPUFrameTimeMS = 0.0f;
+
+	// Amortized rendering state: counter of rendered frames and the camera of the previous frame
+	int32 AmortizedFrameIndex = 0;
+	FTransform LastRenderedTransform;
+	float LastRenderedSize = 0.0f;
+	bool bFullRefreshRequested = false;
+
+	// See GetLastRenderTime()
+	double LastRenderTime = 0.0;
+
 	// Flag telling that UpdateSceneCaptureContents() should pass execution to parent class
 	bool bAllow2DCapture = false;
 
@@ -10,6 +10,7 @@
 class ILookingGlassRuntime;
 struct FLookingGlassBridge;
 struct FLGDeviceCalibration;
+class FLookingGlassRenderTargetPool;
 
 //-------------------------------------------------------------------------------------------------
 // ILookingGlassRuntime Module
@@ -41,12 +42,22 @@ public:
 		return FModuleManager::LoadModuleChecked< ILookingGlassRuntime >("LookingGlassRuntime");
 	}
 
+	// Doesn't wait for Bridge initialization or display enumeration, check IsBridgeReady() before using device data
 	virtual FLookingGlassBridge& GetBridge() = 0;
 
+	// False while Bridge is being initialized or displays are being enumerated on a worker thread
+	virtual bool IsBridgeReady() const = 0;
+
 	virtual bool IsRenderingOnDevice() const = 0;
 
+	// True when the hologram is interleaved by the plugin and shown in the window on the panel, without Bridge
+	virtual bool IsInterleavingInEngine() const = 0;
+
 	virtual const FLGDeviceCalibration& GetCurrentCalibration() const = 0;
 
+	// Render targets shared by all capture components
+	virtual FLookingGlassRenderTargetPool& GetRenderTargetPool() = 0;
+
 	/**
 	 * @fn	static inline bool ILookingGlassRuntime::IsAvailable()
 	 *
@@ -256,6 +256,21 @@ enum class ELookingGlassQuiltOrder : uint8
 	BottomRight_To_TopLeft	UMETA(DisplayName = "Bottom-Right -> Top-Left")
 };
 
+/**
+ * Pixel format of the per-view render targets, the 2D render target and the quilt. Memory is given for a 4096x4096 quilt.
+ * Readback for screenshots and movie capture reads RGBA8 images directly; other formats are converted to 8 bits on GPU first.
+ */
+UENUM(BlueprintType, meta = (ScriptName = "LookingGlassPixelFormat"))
+enum class ELookingGlassPixelFormat : uint8
+{
+	// 8 bits per channel, 4 bytes per pixel (64 MB). Enough for SDR output; the fastest capture, no conversion for readback.
+	RGBA8		UMETA(DisplayName = "RGBA 8-bit"),
+	// 10 bits per color channel and 2-bit alpha, 4 bytes per pixel (64 MB). Less banding in gradients at the cost of RGBA8.
+	RGB10A2		UMETA(DisplayName = "RGB 10-bit"),
+	// 16-bit float per channel, 8 bytes per pixel (128 MB). Needed for HDR capture sources, twice the bandwidth of other formats.
+	FP16		UMETA(DisplayName = "RGBA 16-bit float")
+};
+
 
 /**
  * @struct	FLookingGlassRenderingSettings
@@ -285,6 +300,37 @@ struct FLookingGlassRenderingSettings
 	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "LookingGlass|Rendering")
 	ELookingGlassQuiltOrder QuiltOrder = ELookingGlassQuiltOrder::BottomLeft_To_TopRight; // default to legacy
 
+	// Copy all views to the quilt in a single render pass, with one instanced draw per tiling texture. When disabled,
+	// every view is copied with its own render pass, which is much slower with large number of views.
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "LookingGlass|Rendering")
+	bool bBatchedQuiltCopy = true;
+
+	// Don't wait for the rendering thread at the end of every frame: the quilt recorded in the previous frame is presented
+	// on device while the current one is recorded. Adds one frame of latency.
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "LookingGlass|Rendering")
+	bool bPipelinedFrames = true;
+
+	// Interleave the quilt for the lenticular panel in the plugin, and show the result in a window which covers the
+	// panel, instead of passing the quilt to Bridge. Applied when the player starts on a device. Panels with a subpixel
+	// cell pattern are still presented through Bridge.
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "LookingGlass|Rendering")
+	bool bInterleaveInEngine = false;
+
+	// Number of quilt render targets used for pipelined frames. Every one takes the full quilt size in video memory.
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "LookingGlass|Rendering", meta = (EditCondition = "bPipelinedFrames", ClampMin = "2", ClampMax = "4", UIMin = "2", UIMax = "4"))
+	int32 QuiltRingSize = 2;
+
+	// Number of frames which could be read back from GPU at the same time, for quilt screenshots and movie capture.
+	// Captured frames are delivered this many frames late, but the rendering doesn't wait for GPU.
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "LookingGlass|Rendering", meta = (ClampMin = "1", ClampMax = "8", UIMin = "1", UIMax = "8"))
+	int32 ReadbackRingSize = 3;
+
+	// Render targets of capture components and the quilt ring are released after this many seconds without rendering,
+	// for example when the window is hidden, and created again when rendering resumes. Unused targets of the render
+	// target pool are freed after the same time. 0 keeps them resident.
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "LookingGlass|Rendering", meta = (ClampMin = "0", UIMin = "0", UIMax = "60", Units = "s"))
+	float IdleMemoryReleaseTime = 5.0f;
+
 	void UpdateVsync() const;
 };
 
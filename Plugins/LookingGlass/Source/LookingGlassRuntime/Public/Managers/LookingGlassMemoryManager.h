@@ -0,0 +1,27 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Managers/ILookingGlassManager.h"
+
+/**
+ * @class	FLookingGlassMemoryManager
+ *
+ * @brief	Releases render targets of capture components and the quilt ring when they weren't used for
+ * 			FLookingGlassRenderingSettings::IdleMemoryReleaseTime seconds, and frees idle targets of the render
+ * 			target pool. Everything is created again when rendering resumes.
+ */
+
+class FLookingGlassMemoryManager : public ILookingGlassManager
+{
+public:
+	FLookingGlassMemoryManager();
+	virtual ~FLookingGlassMemoryManager();
+
+	/** ILookingGlassManager Interface */
+	virtual void Tick(float DeltaTime) override;
+	/** ILookingGlassManager Interface */
+
+private:
+	// Releases render targets of the component if it hasn't rendered since IdleSince
+	void ReleaseIdleComponent(class ULookingGlassSceneCaptureComponent2D* CaptureComponent, double IdleSince);
+};
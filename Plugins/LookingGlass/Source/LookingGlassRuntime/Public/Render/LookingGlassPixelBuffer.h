@@ -0,0 +1,70 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * @struct	FLookingGlassPixelBuffer
+ *
+ * @brief	CPU copy of a rendered frame. Buffers are allocated from FLookingGlassPixelBufferPool and are passed around
+ * 			as shared references, so the frame travels from GPU readback to the image writer without being copied.
+ * 			The buffer returns to the pool when the last reference is released, on any thread.
+ */
+
+struct LOOKINGGLASSRUNTIME_API FLookingGlassPixelBuffer
+{
+	// Pixels in BGRA8 format, with full alpha
+	TArray64<FColor> Pixels;
+
+	FIntPoint Size = FIntPoint::ZeroValue;
+};
+
+typedef TSharedRef<FLookingGlassPixelBuffer, ESPMode::ThreadSafe> FLookingGlassPixelBufferRef;
+typedef TSharedPtr<FLookingGlassPixelBuffer, ESPMode::ThreadSafe> FLookingGlassPixelBufferPtr;
+
+/**
+ * @class	FLookingGlassPixelBufferPool
+ *
+ * @brief	Thread safe pool of frame buffers. Reuses memory of released buffers, so long movie renders don't
+ * 			reallocate a full quilt every frame. Number of idle buffers kept in the pool is limited.
+ */
+
+class LOOKINGGLASSRUNTIME_API FLookingGlassPixelBufferPool
+{
+public:
+	static FLookingGlassPixelBufferPool& Get();
+
+	/**
+	 * @fn	FLookingGlassPixelBufferRef FLookingGlassPixelBufferPool::Acquire(const FIntPoint& Size);
+	 *
+	 * @brief	Gets a buffer of the given size, pixel data is not initialized
+	 *
+	 * @param	Size	Image size.
+	 *
+	 * @returns	The buffer.
+	 */
+
+	FLookingGlassPixelBufferRef Acquire(const FIntPoint& Size);
+
+	// Maximal number of idle buffers kept for reuse
+	void SetMaxIdleBuffers(int32 InMaxIdleBuffers);
+
+	// Free all idle buffers
+	void Trim();
+
+	int64 GetAllocatedBytes() const;
+
+private:
+	void Release(FLookingGlassPixelBuffer* Buffer);
+
+	void UpdateStats() const;
+
+	mutable FCriticalSection Mutex;
+
+	TArray<FLookingGlassPixelBuffer*> IdleBuffers;
+
+	int32 MaxIdleBuffers = 4;
+
+	// Number of buffers in use, and memory of all buffers including idle ones
+	int32 NumUsedBuffers = 0;
+	int64 AllocatedBytes = 0;
+};
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "PixelFormat.h"
+#include "UObject/GCObject.h"
+#include "Runtime/Launch/Resources/Version.h"
+
+class UTextureRenderTarget2D;
+
+/**
+ * @class	FLookingGlassRenderTargetPool
+ *
+ * @brief	Plugin-wide pool of render targets, shared by all capture components. Targets are leased by size and pixel
+ * 			format, and returned targets are reused by the next lease with the same key, so switching tiling back and
+ * 			forth or rendering with several components doesn't allocate new textures. Targets which stay idle for
+ * 			longer than the idle time set with SetIdleTime() are freed. Should be used on the game thread only.
+ */
+
+class LOOKINGGLASSRUNTIME_API FLookingGlassRenderTargetPool : public FGCObject
+{
+public:
+	/**
+	 * @fn	UTextureRenderTarget2D* FLookingGlassRenderTargetPool::Acquire(const FIntPoint& Size, EPixelFormat Format);
+	 *
+	 * @brief	Leases a render target. A reused target keeps the picture of its previous user.
+	 *
+	 * @param	Size  	Size of the render target.
+	 * @param	Format	Pixel format of the render target.
+	 *
+	 * @returns	The render target, which should be returned with Release().
+	 */
+
+	UTextureRenderTarget2D* Acquire(const FIntPoint& Size, EPixelFormat Format);
+
+	// Return a leased target to the pool
+	void Release(UTextureRenderTarget2D* RenderTarget);
+
+	// Free targets which were idle for longer than MaxIdleTime seconds, all idle targets with 0
+	void Trim(double MaxIdleTime = 0.0);
+
+	// Seconds after which an idle target is freed, 0 keeps idle targets until Trim() is called. Set by
+	// FLookingGlassMemoryManager from FLookingGlassRenderingSettings::IdleMemoryReleaseTime.
+	void SetIdleTime(double InIdleTime) { IdleTime = InIdleTime; }
+
+	// Memory of leased and idle targets
+	int64 GetLeasedBytes() const { return LeasedBytes; }
+	int64 GetIdleBytes() const { return IdleBytes; }
+
+	//~ Begin FGCObject Interface
+	virtual void AddReferencedObjects(FReferenceCollector& Collector) override;
+	virtual FString GetReferencerName() const override;
+	//~ End FGCObject Interface
+
+	static int64 GetTextureBytes(const FIntPoint& Size, EPixelFormat Format);
+
+private:
+	void UpdateStats() const;
+
+	struct FIdleTarget
+	{
+#if (ENGINE_MAJOR_VERSION < 5) || (ENGINE_MAJOR_VERSION == 5 && ENGINE_MINOR_VERSION < 6)
+		UTextureRenderTarget2D* RenderTarget;
+#else // EU5.6+
+		TObjectPtr<UTextureRenderTarget2D> RenderTarget;
+#endif
+		double ReleaseTime;
+	};
+
+	TArray<FIdleTarget> IdleTargets;
+
+	// Leased targets are referenced here as well, so a target returned from a destructor is still alive
+#if (ENGINE_MAJOR_VERSION < 5) || (ENGINE_MAJOR_VERSION == 5 && ENGINE_MINOR_VERSION < 6)
+	TArray<UTextureRenderTarget2D*> LeasedTargets;
+#else // EU5.6+
+	TArray<TObjectPtr<UTextureRenderTarget2D>> LeasedTargets;
+#endif
+
+	double IdleTime = 0.0;
+
+	int64 LeasedBytes = 0;
+	int64 IdleBytes = 0;
+};
@@ -3,10 +3,13 @@
 
 #include "CoreMinimal.h"
 #include "Misc/CoreMisc.h"
+#include "HAL/ThreadSafeCounter.h"
 
 #include "LookingGlassSettings.h"
+#include "Render/LookingGlassPixelBuffer.h"
 
 #include "Widgets/SWindow.h"
+#include "RenderingThread.h" // for FRenderCommandFence
 #include "Runtime/Launch/Resources/Version.h"
 #if ENGINE_MAJOR_VERSION == 5 && ENGINE_MINOR_VERSION >= 2
 #include "ViewportClient.h"
@@ -19,8 +22,15 @@ class ULookingGlassSceneCaptureComponent2D;
 class FViewport;
 class FSceneViewport;
 
+namespace LookingGlass
+{
+	struct FFrameGraphDesc;
+	class FQuiltReadbackRing;
+}
+
 DECLARE_MULTICAST_DELEGATE(FOnLookingGlassScreenshotRequestProcessed);
-DECLARE_MULTICAST_DELEGATE_ThreeParams(FOnLookingGlassFrameReady, const TArray<FColor>& /* Buffer */, int32 /* Width */, int32 /* Height */);
+// The buffer is shared with all listeners, and returns to the pool when the last reference to it is released
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnLookingGlassFrameReady, const FLookingGlassPixelBufferRef& /* Buffer */);
 
 /**
  * @struct	FLookingGlassScreenshotRequest
@@ -298,6 +308,12 @@ public:
 		Window = InWindow;
 	}
 
+	// Releases the quilt ring, it is created again by the next Draw(). Used when nothing has been drawn for a while.
+	void ReduceMemoryUse();
+
+	// Time of the recent Draw() call, in FPlatformTime::Seconds()
+	double GetLastDrawTime() const { return LastDrawTime; }
+
 	/**
 	 * @fn	void FLookingGlassViewportClient::SetIgnoreInput(bool Ignore)
 	 *
@@ -353,9 +369,14 @@ private:
 
 	virtual bool Exec(UWorld* InWorld, const TCHAR* Cmd, FOutputDevice& Ar) override;
 
-	void VisualizeRenderTarget(FViewport* InViewport, UTextureRenderTarget2D* QuiltRT, bool bRenderOnDevice, const FIntPoint& Tiles, float Aspect);
+	// Pass composed quilt to the device through Bridge
+	void VisualizeRenderTarget(UTextureRenderTarget2D* QuiltRT, const FIntPoint& Tiles, float Aspect);
+
+	// Render views of the capture component. Copies to the quilt which should be done after that are added to GraphDesc.
+	void RenderToQuilt(ULookingGlassSceneCaptureComponent2D* CaptureComponent, UTextureRenderTarget2D* InQuiltRT, LookingGlass::FFrameGraphDesc& GraphDesc);
 
-	void RenderToQuilt(ULookingGlassSceneCaptureComponent2D* CaptureComponent, UTextureRenderTarget2D* InQuiltRT);
+	// Enqueue the frame graph to rendering thread
+	void ExecuteFrameGraph(LookingGlass::FFrameGraphDesc& GraphDesc);
 
 	/**
 	 * @fn	bool FLookingGlassViewportClient::HandleScreenshotQuiltCommand(const TCHAR* Cmd, FOutputDevice& Ar);
@@ -397,6 +418,9 @@ private:
 
 	bool HandleRenderingCommand(const TCHAR* Cmd, FOutputDevice& Ar);
 
+	// Log passes and textures of the next frame graph
+	bool HandleDumpGraphCommand(const TCHAR* Cmd, FOutputDevice& Ar);
+
 	bool PrepareScreenshotQuilt(const FString& FileName, bool bAddFilenameSuffix, FLookingGlassScreenshotRequest::FCallback Callback = FLookingGlassScreenshotRequest::FCallback());
 	bool PrepareScreenshot2D(const FString& FileName, bool bAddFilenameSuffix);
 
@@ -412,40 +436,79 @@ private:
 
 	void ParseScreenshotCommand(const TCHAR * Cmd, FString& InName, bool& InSuffix);
 
-	void ProcessScreenshotQuilt(UTextureRenderTarget2D* QuiltRT);
+	// Request asynchronous readback of the quilt for the pending screenshot. The file is saved when data arrives.
+	void ProcessScreenshotQuilt(LookingGlass::FFrameGraphDesc& GraphDesc);
+
+	// Request asynchronous readback of the quilt, and pass it as FBitmap to movie capture when ready
+	void ProcessQuiltForMovie(LookingGlass::FFrameGraphDesc& GraphDesc);
+
+	// Render the 2D view at screenshot resolution, and request its asynchronous readback. The file is saved when data arrives.
+	void ProcessScreenshot2D(TWeakObjectPtr<ULookingGlassSceneCaptureComponent2D> LookingGlassCaptureComponent);
+
+	// A quilt render target of the ring used for pipelined frames
+	struct FQuiltFrame
+	{
+		UTextureRenderTarget2D* QuiltRT = nullptr;
+		// Passed when rendering thread has processed all commands recorded for this quilt
+		FRenderCommandFence Fence;
+		// Native texture registered in Bridge, used to unregister it when the texture is recreated
+		void* BridgeTexture = nullptr;
+		// Native textures replaced by recreation of QuiltRT. They're unregistered from Bridge at the next present of this
+		// frame, when its fence confirms that rendering thread has switched to the new texture.
+		TArray<void*, TInlineAllocator<1>> StaleBridgeTextures;
+		// Presentation parameters, and time when the frame has been submitted to rendering thread
+		FIntPoint Tiles = FIntPoint(1, 1);
+		float Aspect = 1.0f;
+		double SubmitTime = 0;
+		bool bPresented = false;
+	};
 
-	// Pass quilt as FBitmap to movie capture
-	void ProcessQuiltForMovie(UTextureRenderTarget2D* QuiltRT);
+	// Remember the Bridge texture of a quilt which is recreated, see FQuiltFrame::StaleBridgeTextures
+	static void RetireBridgeTexture(FQuiltFrame& Frame);
+
+	// Recreate the quilt ring if number of quilts has been changed
+	void UpdateQuiltRing(int32 RingSize);
+
+	void ReleaseQuiltFrames();
+
+	// Updates the resident memory stat of the quilt ring
+	void UpdateQuiltRingStats() const;
 
 	/**
-	 * @fn	bool FLookingGlassViewportClient::GetRenderTargetScreenShot(TWeakObjectPtr<UTextureRenderTarget2D> TextureRenderTarget2D, TArray<FColor>& Bitmap, const FIntRect& ViewRect = FIntRect());
+	 * @fn	int32 FLookingGlassViewportClient::AcquireQuiltFrame(TWeakObjectPtr<ULookingGlassSceneCaptureComponent2D> LookingGlassCaptureComponent);
 	 *
-	 * @brief	Gets render target screen in bytes array on CPU
+	 * @brief	Gets the next quilt of the ring for rendering, creates or resizes its render target
 	 *
-	 * @param 		  	TextureRenderTarget2D	The texture render target 2D.
-	 * @param [in,out]	Bitmap				 	The bitmap.
-	 * @param 		  	ViewRect			 	(Optional) The view rectangle.
+	 * @param	LookingGlassCaptureComponent	The LookingGlass capture.
 	 *
-	 * @returns	True if it succeeds, false if it fails.
+	 * @returns	Index of the quilt frame.
 	 */
 
-	bool GetRenderTargetScreenShot(TWeakObjectPtr<UTextureRenderTarget2D> TextureRenderTarget2D, TArray<FColor>& Bitmap, const FIntRect& ViewRect = FIntRect());
+	int32 AcquireQuiltFrame(TWeakObjectPtr<ULookingGlassSceneCaptureComponent2D> LookingGlassCaptureComponent);
 
-	void ProcessScreenshot2D(TWeakObjectPtr<ULookingGlassSceneCaptureComponent2D> LookingGlassCaptureComponent);
+	// Mark the quilt as recorded, it could be presented once its fence is passed
+	void SubmitQuiltFrame(int32 FrameIndex, const FIntPoint& Tiles, float Aspect);
+
+	void WaitForQuiltFrame(FQuiltFrame& Frame);
+
+	// Pass the quilt to device, and update frame pacing stats
+	void PresentQuiltFrame(int32 FrameIndex);
 
 	/**
-	 * @fn	UTextureRenderTarget2D* FLookingGlassViewportClient::GetQuiltRT(TWeakObjectPtr<ULookingGlassSceneCaptureComponent2D> LookingGlassCaptureComponent);
-	 *
-	 * @brief	Gets quilt render target texture
+	 * @fn	void FLookingGlassViewportClient::SaveScreenShotAsync(const FLookingGlassPixelBufferRef& Buffer, const FString& ScreenShotName, const FLookingGlassScreenshotSettings& ScreenShotSettings, TUniqueFunction<void()>&& OnSaved);
 	 *
-	 * @param	LookingGlassCapture	The LookingGlass capture.
+	 * @brief	Encodes and writes the screenshot on a background thread, so the game thread is not blocked
 	 *
-	 * @returns	Null if it fails, else the quilt right.
+	 * @param	Buffer			  	Image data, referenced until the file is written.
+	 * @param	ScreenShotName	  	Name of the file, the extension is replaced according to settings.
+	 * @param	ScreenShotSettings	Image format settings.
+	 * @param	OnSaved			  	Called on game thread when the file is written, or when saving has failed.
 	 */
 
-	UTextureRenderTarget2D* GetQuiltRT(TWeakObjectPtr<ULookingGlassSceneCaptureComponent2D> LookingGlassCaptureComponent);
+	void SaveScreenShotAsync(const FLookingGlassPixelBufferRef& Buffer, const FString& ScreenShotName, const FLookingGlassScreenshotSettings& ScreenShotSettings, TUniqueFunction<void()>&& OnSaved);
 
-	void SaveScreenShot(const TArray<FColor>& Bitmap, const FIntVector& Size, const FString& ScreenShotName, const FLookingGlassScreenshotSettings* pScreenShotSettings);
+	// Wait for screenshots which are being saved in background, and call their completion callbacks
+	void FlushScreenShotSaves();
 
 #if WITH_EDITOR
 	// Event handlers for noticing level editor viewport redraws
@@ -466,13 +529,26 @@ private:
 
 	EMouseCursor::Type CurrentMouseCursor;
 
-	UTextureRenderTarget2D* StaticQuiltRT;
+	// Quilt render targets. There's only one of them unless frames are pipelined.
+	TArray<FQuiltFrame> QuiltFrames;
+	int32 LastQuiltFrameIndex;
+	double LastQuiltPresentTime;
+	double LastDrawTime;
+
+	// Asynchronous readbacks of quilt for screenshots and movie capture
+	TUniquePtr<LookingGlass::FQuiltReadbackRing> QuiltReadbacks;
+
+	// Number of screenshots being encoded and written in background, including their pending completion callbacks
+	FThreadSafeCounter NumScreenShotSaves;
 
 	// Information about last rendered scene, used for ELookingGlassPerformanceMode::NonRealtime
 	ULookingGlassSceneCaptureComponent2D* LastRenderedComponent;
 	double LastViewportUpdateTime;
 	bool bLastModeWas2D;
 
+	// Set by LookingGlass.DumpGraph command
+	bool bDumpNextFrameGraph;
+
 public:
 	/** Slate window associated with this viewport client.  The same window may host more than one viewport client. */
 	TWeakPtr<SWindow> Window;
@@ -7,11 +7,36 @@
 #include "AVIWriter.h"
 
 #include "LookingGlassSettings.h"
+#include "Render/LookingGlassPixelBuffer.h"
 
 #include "LookingGlassProtocol.generated.h"
 
 class IImageWriteQueue;
 
+namespace LookingGlass
+{
+	class FMatroskaWriter;
+}
+
+// What the capture does when the queue of frames waiting for encoding is full
+UENUM()
+enum class ELookingGlassCaptureQueuePolicy : uint8
+{
+	// Wait for the encoder, so Sequencer doesn't advance to the next frame until there's room in the queue
+	Throttle		UMETA(DisplayName = "Wait for encoder"),
+	// Skip frames while the queue is full
+	DropFrames		UMETA(DisplayName = "Drop frames")
+};
+
+// Frames handed over to the encoder, shared with image write tasks which could outlive the protocol object
+struct FLookingGlassCaptureQueueState
+{
+	FThreadSafeCounter EncodingFrameCount;
+	FThreadSafeCounter EncodedFrameCount;
+};
+
+typedef TSharedRef<FLookingGlassCaptureQueueState, ESPMode::ThreadSafe> FLookingGlassCaptureQueueStateRef;
+
 struct IFramePayload
 {
 	virtual ~IFramePayload() {}
@@ -36,8 +61,8 @@ struct FCapturedFrameData
 	template<typename T>
 	T* GetPayload() { return static_cast<T*>(Payload.Get()); }
 
-	/** The color buffer of the captured frame */
-	TArray<FColor> ColorBuffer;
+	/** The color buffer of the captured frame, shared with the viewport client and returned to the pool when released */
+	FLookingGlassPixelBufferPtr ColorBuffer;
 
 	/** The size of the resulting color buffer */
 	FIntPoint BufferSize;
@@ -66,7 +91,7 @@ public:
 protected:
 
 	// Callback from FLookingGlassViewportClient when the new bitmap is ready for being used in capture
-	void OnFrameReady(const TArray<FColor>& Bitmap, int32 Width, int32 Height);
+	void OnFrameReady(const FLookingGlassPixelBufferRef& Buffer);
 
 #if WITH_EDITOR
 	void PostEditChangeProperty(struct FPropertyChangedEvent& PropertyChangedEvent) override;
@@ -112,6 +137,21 @@ protected:
 	/** Lock to protect the above array */
 	mutable FCriticalSection CapturedFramesMutex;
 
+	/** Frames which are waiting for the encoder, or being encoded */
+	FLookingGlassCaptureQueueStateRef QueueState = MakeShared<FLookingGlassCaptureQueueState, ESPMode::ThreadSafe>();
+
+	/** Number of frames in the capture queue: captured but not yet passed to ProcessFrame, plus frames being encoded */
+	int32 GetQueuedFrameCount() const;
+
+	/** Pass captured frames to ProcessFrame() */
+	void ProcessCapturedFrames();
+
+	/** Update queue depth and encoder throughput stats */
+	void UpdateQueueStats();
+
+	double LastThroughputTime = 0;
+	int32 LastEncodedFrameCount = 0;
+
 	// Update the video/image resolution depending on the current TilingSettings
 	void UpdateResolutionInUI();
 
@@ -124,6 +164,14 @@ public:
 	// Resolution and tiling settings of the generated image/video sequence
 	UPROPERTY(config, EditAnywhere, Category="LookingGlass")
 	ELookingGlassQualitySettings TilingSettings = ELookingGlassQualitySettings::Q_GoPortrait;
+
+	// Maximal number of captured frames waiting for the encoder. Limits memory used by the capture.
+	UPROPERTY(config, EditAnywhere, AdvancedDisplay, Category="LookingGlass", meta=(ClampMin=1, UIMin=1, UIMax=64))
+	int32 MaxQueuedFrames = 8;
+
+	// What to do when the encoder can't keep up and the queue is full
+	UPROPERTY(config, EditAnywhere, AdvancedDisplay, Category="LookingGlass")
+	ELookingGlassCaptureQueuePolicy QueueFullPolicy = ELookingGlassCaptureQueuePolicy::Throttle;
 };
 
 // Reference: UImageSequenceProtocol + UCompressedImageSequenceProtocol
@@ -200,3 +248,75 @@ protected:
 
 	TArray<TUniquePtr<FAVIWriter>> AVIWriters;
 };
+
+// Streaming Motion JPEG video in Matroska container. Frames are compressed on worker threads with the parallel
+// JPEG encoder, and written in order as they complete. Doesn't depend on platform codecs, so it works on every
+// platform the runtime module is allowed on (Win64 and Linux), unlike the AVI protocol which needs the engine's AVI
+// writer. Other platforms would need an entry in LookingGlass.uplugin.
+UCLASS(meta=(DisplayName="LookingGlass Video (mkv, Motion JPEG)"))
+class ULookingGlassProtocol_MKV : public ULookingGlassProtocol
+{
+	GENERATED_BODY()
+
+public:
+	ULookingGlassProtocol_MKV(const FObjectInitializer& ObjInit)
+	: Super(ObjInit)
+	, CompressionQuality(90)
+	, bAddQuiltSettingsSuffix(true)
+	, FirstFrameNumber(0)
+	{}
+
+	/** ~ UMovieSceneCaptureProtocol implementation */
+	virtual bool SetupImpl() override;
+	virtual void TickImpl() override;
+	virtual void FinalizeImpl() override;
+	virtual bool CanWriteToFileImpl(const TCHAR* InFilename, bool bOverwriteExisting) const override;
+	/** ~End UMovieSceneCaptureProtocol implementation */
+
+	/** ~ULookingGlassProtocol implementation */
+	virtual FFramePayloadPtr GetFramePayload(const FFrameMetrics& FrameMetrics) override;
+	virtual void ProcessFrame(FCapturedFrameData Frame) override;
+	/** ~End ULookingGlassProtocol implementation */
+
+	/** JPEG quality of frames, between 1 (worst quality, best compression) and 100 (best quality, worst compression) */
+	UPROPERTY(config, EditAnywhere, Category=VideoSettings, meta=(ClampMin=1, ClampMax=100))
+	int32 CompressionQuality;
+
+	/** Add quilt settings to the file name, e.g. "_qs8x6a0.75", so LookingGlass players could recognize the quilt layout */
+	UPROPERTY(config, EditAnywhere, Category=VideoSettings)
+	bool bAddQuiltSettingsSuffix;
+
+protected:
+	// A frame being encoded in background
+	struct FPendingFrame
+	{
+		TFuture<TArray64<uint8>> Data;
+		FString Filename;
+		FIntPoint Size;
+		int32 FrameNumber;
+	};
+
+	/**
+	 * @fn	void ULookingGlassProtocol_MKV::WriteEncodedFrames(bool bWait);
+	 *
+	 * @brief	Writes encoded frames to video files, in order of capture
+	 *
+	 * @param	bWait	Wait for all frames to be encoded, otherwise stop at the first frame which is not ready.
+	 */
+
+	void WriteEncodedFrames(bool bWait);
+
+	// Start a new video file when the file name changes, e.g. for a new shot
+	void ConditionallyCreateWriter(const FPendingFrame& Frame);
+
+	TArray<FPendingFrame> PendingFrames;
+
+	// Shared pointer, because the writer type is private to the module
+	TSharedPtr<LookingGlass::FMatroskaWriter> Writer;
+
+	// Names of all files written by this capture
+	TArray<FString> WrittenFilenames;
+
+	// Frame number of the first frame of the current file
+	int32 FirstFrameNumber;
+};